@@ -0,0 +1,185 @@
+/**
+ * Benchmarks dynamic_list against the implementation it replaced, which
+ * reallocated on every append and shifted items one by one on removal.
+ *
+ * Run with `make bench`.
+ */
+#define _POSIX_C_SOURCE 200809L
+#include "../src/include/dynamic_list.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+
+/* ==== the previous implementation ==== */
+
+typedef struct LEGACY_LIST_STRUCT
+{
+    size_t size;
+    size_t item_size;
+    void** items;
+} legacy_list_T;
+
+static legacy_list_T* init_legacy_list(size_t item_size)
+{
+    legacy_list_T* list = calloc(1, sizeof(struct LEGACY_LIST_STRUCT));
+    list->item_size = item_size;
+
+    return list;
+}
+
+static void legacy_list_append(legacy_list_T* list, void* item)
+{
+    list->size++;
+    list->items = realloc(list->items, (list->size + 1) * list->item_size);
+    list->items[list->size - 1] = item;
+}
+
+static void legacy_list_remove(legacy_list_T* list, void* element)
+{
+    int index = 0;
+
+    for (int i = 0; i < list->size; i++)
+    {
+        if (list->items[i] == element)
+        {
+            index = i;
+            break;
+        }
+    }
+
+    for (int i = index; i < list->size - 1; i++)
+        list->items[i] = list->items[i + 1];
+
+    list->items = realloc(list->items, (list->size - 1) * list->item_size);
+    list->size -= 1;
+}
+
+static void legacy_list_free(legacy_list_T* list)
+{
+    free(list->items);
+    free(list);
+}
+
+
+/* ==== benchmarks ==== */
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void report(const char* name, double legacy, double current)
+{
+    printf("%-36s %10.3f ms %10.3f ms %8.1fx\n", name, legacy * 1000, current * 1000, legacy / current);
+}
+
+static void bench_append(size_t n)
+{
+    char name[64];
+    sprintf(name, "append %zu items", n);
+
+    double start = now();
+    legacy_list_T* legacy = init_legacy_list(sizeof(void*));
+
+    for (size_t i = 0; i < n; i++)
+        legacy_list_append(legacy, (void*) (i + 1));
+
+    legacy_list_free(legacy);
+    double legacy_time = now() - start;
+
+    start = now();
+    dynamic_list_T* list = init_dynamic_list(sizeof(void*));
+
+    for (size_t i = 0; i < n; i++)
+        dynamic_list_append(list, (void*) (i + 1));
+
+    dynamic_list_free(list);
+
+    report(name, legacy_time, now() - start);
+}
+
+static void bench_small_lists(size_t lists, size_t items)
+{
+    char name[64];
+    sprintf(name, "%zu lists of %zu items", lists, items);
+
+    double start = now();
+
+    for (size_t l = 0; l < lists; l++)
+    {
+        legacy_list_T* legacy = init_legacy_list(sizeof(void*));
+
+        for (size_t i = 0; i < items; i++)
+            legacy_list_append(legacy, (void*) (i + 1));
+
+        legacy_list_free(legacy);
+    }
+
+    double legacy_time = now() - start;
+
+    start = now();
+
+    for (size_t l = 0; l < lists; l++)
+    {
+        dynamic_list_T* list = init_dynamic_list(sizeof(void*));
+
+        for (size_t i = 0; i < items; i++)
+            dynamic_list_append(list, (void*) (i + 1));
+
+        dynamic_list_free(list);
+    }
+
+    report(name, legacy_time, now() - start);
+}
+
+static void bench_remove_front(size_t n)
+{
+    char name[64];
+    sprintf(name, "remove %zu items from the front", n);
+
+    legacy_list_T* legacy = init_legacy_list(sizeof(void*));
+    dynamic_list_T* list = init_dynamic_list(sizeof(void*));
+
+    for (size_t i = 0; i < n; i++)
+    {
+        legacy_list_append(legacy, (void*) (i + 1));
+        dynamic_list_append(list, (void*) (i + 1));
+    }
+
+    double start = now();
+
+    while (legacy->size > 1)
+        legacy_list_remove(legacy, legacy->items[0]);
+
+    double legacy_time = now() - start;
+
+    start = now();
+
+    while (list->size > 1)
+        dynamic_list_remove_at(list, 0);
+
+    report(name, legacy_time, now() - start);
+
+    legacy_list_free(legacy);
+    dynamic_list_free(list);
+}
+
+int main(int argc, char* argv[])
+{
+    printf("%-36s %13s %13s %9s\n", "", "previous", "current", "speedup");
+
+    bench_append(1000);
+    bench_append(100000);
+    bench_append(1000000);
+    bench_small_lists(1000000, 2);
+    bench_small_lists(1000000, 4);
+    bench_small_lists(100000, 16);
+    bench_remove_front(10000);
+    bench_remove_front(50000);
+
+    return 0;
+}
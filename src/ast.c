@@ -2,6 +2,13 @@
 #include "include/holyc_scope.h"
 #include "include/string_utils.h"
 #include "include/token.h"
+#include "include/holyc_typed_list.h"
+#include "include/holyc_deque.h"
+#include "include/holyc_map.h"
+#include "include/holyc_bitset.h"
+#include "include/holyc_heap.h"
+#include "include/holyc_string.h"
+#include "include/holyc_format.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -50,6 +57,7 @@ AST_T* init_ast(int type)
     AST->ast = (void*) 0;
     AST->parent = (void*) 0;
     AST->list_children = AST->type == AST_LIST ? init_dynamic_list(sizeof(struct AST_STRUCT*)) : (void*) 0;
+    AST->typed_list = (void*) 0;
     AST->function_definitions = (void*) 0;
     AST->composition_children = AST->type == AST_FUNCTION_DEFINITION ? init_dynamic_list(sizeof(struct AST_STRUCT*)) : (void*) 0;
     AST->function_definition_body = (void*) 0;
@@ -108,7 +116,14 @@ void ast_free(AST_T* ast)
         ast_free(ast->function_call_expr);
 
     if (ast->string_value)
-        free(ast->string_value); 
+    {
+        holyc_string_T* header = ast->string_header;
+
+        if (header && ast->string_value == header->data)
+            holyc_string_free(header);
+        else
+            free(ast->string_value);
+    }
 
     if (ast->variable_name)
         free(ast->variable_name);
@@ -161,8 +176,7 @@ void ast_free(AST_T* ast)
                 ast_free((AST_T*)ast->compound_value->items[i]);
         }
 
-        free(ast->compound_value->items);
-        free(ast->compound_value);
+        dynamic_list_free(ast->compound_value);
         ast->compound_value = (void*) 0;
     }
 
@@ -174,8 +188,7 @@ void ast_free(AST_T* ast)
                 ast_free((AST_T*)ast->function_call_arguments->items[i]);
         }
 
-        free(ast->function_call_arguments->items);
-        free(ast->function_call_arguments);
+        dynamic_list_free(ast->function_call_arguments);
         ast->function_call_arguments = (void*) 0;
     }
 
@@ -187,8 +200,7 @@ void ast_free(AST_T* ast)
                 ast_free((AST_T*)ast->function_definition_arguments->items[i]);
         }
 
-        free(ast->function_definition_arguments->items);
-        free(ast->function_definition_arguments);
+        dynamic_list_free(ast->function_definition_arguments);
         ast->function_definition_arguments = (void*) 0;
     }
 
@@ -207,6 +219,12 @@ void ast_free(AST_T* ast)
         // TODO: free
     }
 
+    if (ast->typed_list)
+    {
+        holyc_typed_list_free(ast->typed_list);
+        ast->typed_list = (void*) 0;
+    }
+
     if (ast->function_definitions)
     {
         //free(ast->function_definitions->items);
@@ -222,8 +240,7 @@ void ast_free(AST_T* ast)
                 ast_free((AST_T*)ast->composition_children->items[i]);
         }
 
-        free(ast->composition_children->items);
-        free(ast->composition_children);
+        dynamic_list_free(ast->composition_children);
         ast->composition_children = (void*) 0;
     } 
 
@@ -356,8 +373,7 @@ AST_T* ast_copy_string(AST_T* ast)
 {
     AST_T* a = init_ast(ast->type);
     a->scope = ast->scope;
-    a->string_value = calloc(strlen(ast->string_value) + 1, sizeof(char));
-    strcpy(a->string_value, ast->string_value);
+    ast_string_set(a, init_holyc_string(ast->string_value, ast_string_length(ast)));
 
     return a;
 }
@@ -385,6 +401,9 @@ AST_T* ast_copy_list(AST_T* ast)
     AST_T* a = init_ast(ast->type);
     a->scope = ast->scope;
     a->list_children = init_dynamic_list(sizeof(struct AST_STRUCT*));
+
+    if (ast->typed_list)
+        a->typed_list = holyc_typed_list_copy(ast->typed_list);
     
     for (int i = 0; i < ast->list_children->size; i++)
     {
@@ -412,6 +431,10 @@ AST_T* ast_copy_integer(AST_T* ast)
     a->int_value = ast->int_value;
     a->long_int_value = ast->long_int_value;
 
+    // the type says which of the two values is used, see ast_int_value.
+    if (ast->type_value)
+        a->type_value = data_type_copy(ast->type_value);
+
     return a;
 }
 
@@ -538,6 +561,118 @@ AST_T* ast_copy_while(AST_T* ast)
     return a;
 }
 
+AST_T* ast_copy_deque(AST_T* ast)
+{
+    AST_T* a = init_ast(ast->type);
+    a->object_value = holyc_deque_copy((holyc_deque_T*) ast->object_value);
+    a->function_definitions = ast->function_definitions;
+
+    return a;
+}
+
+AST_T* ast_copy_map(AST_T* ast)
+{
+    AST_T* a = init_ast(ast->type);
+    a->function_definitions = ast->function_definitions;
+
+    // a literal that was never visited is copied as a literal.
+    if (ast->object_value)
+    {
+        a->object_value = holyc_map_copy((holyc_map_T*) ast->object_value);
+        return a;
+    }
+
+    a->list_children = init_dynamic_list(sizeof(struct AST_STRUCT*));
+
+    for (int i = 0; i < ast->list_children->size; i++)
+        dynamic_list_append(a->list_children, ast_copy(ast->list_children->items[i]));
+
+    return a;
+}
+
+AST_T* ast_copy_bitset(AST_T* ast)
+{
+    AST_T* a = init_ast(ast->type);
+    a->object_value = holyc_bitset_copy((holyc_bitset_T*) ast->object_value);
+    a->function_definitions = ast->function_definitions;
+
+    return a;
+}
+
+AST_T* ast_copy_heap(AST_T* ast)
+{
+    AST_T* a = init_ast(ast->type);
+    a->object_value = holyc_heap_copy((holyc_heap_T*) ast->object_value);
+    a->function_definitions = ast->function_definitions;
+
+    return a;
+}
+
+AST_T* ast_copy_builder(AST_T* ast)
+{
+    holyc_string_T* string = (holyc_string_T*) ast->object_value;
+
+    AST_T* a = init_ast(ast->type);
+    a->object_value = init_holyc_string(string->data, string->length);
+    a->function_definitions = ast->function_definitions;
+
+    return a;
+}
+
+/**
+ * Copies scalar values (ints, floats, chars, booleans and strings), which
+ * are modified in place by the runtime, other values are returned as is.
+ * Used when a value is stored in a container.
+ *
+ * @param AST_T* ast
+ *
+ * @return AST_T*
+ */
+AST_T* ast_copy_value(AST_T* ast)
+{
+    switch (ast->type)
+    {
+        case AST_INTEGER:
+        case AST_FLOAT:
+        case AST_CHAR:
+        case AST_BOOLEAN:
+        case AST_STRING: return ast_copy(ast); break;
+        default: return ast; break;
+    }
+}
+
+/**
+ * Returns the value of an integer, long_int_value if it is a long int and
+ * int_value otherwise.
+ *
+ * @param AST_T* ast
+ *
+ * @return int64_t
+ */
+int64_t ast_int_value(AST_T* ast)
+{
+    return data_type_has_modifier(ast->type_value, DATA_TYPE_MODIFIER_LONG) ? ast->long_int_value : ast->int_value;
+}
+
+/**
+ * Sets the value of an integer, which becomes a long int if the value does
+ * not fit in an int.
+ *
+ * @param AST_T* ast
+ * @param int64_t value
+ */
+void ast_set_int_value(AST_T* ast, int64_t value)
+{
+    ast->int_value = (int) value;
+    ast->long_int_value = value;
+
+    if (value != (int64_t) ast->int_value)
+    {
+        ast->type_value = init_data_type_as(DATA_TYPE_INT);
+        ast->type_value->modifiers[0] = DATA_TYPE_MODIFIER_LONG;
+    }
+}
+
 static AST_T* ast_r_scope(AST_T* ast, struct holyc_scope_T* scope)
 {
     ast->scope = scope;
@@ -575,10 +710,284 @@ AST_T* ast_copy(AST_T* ast)
         case AST_RETURN: return ast_r_scope(ast_copy_return(ast), ast->scope); break;
         case AST_IF: return ast_r_scope(ast_copy_if(ast), ast->scope); break;
         case AST_WHILE: return ast_r_scope(ast_copy_while(ast), ast->scope); break;
+        case AST_DEQUE: return ast_r_scope(ast_copy_deque(ast), ast->scope); break;
+        case AST_MAP: return ast_r_scope(ast_copy_map(ast), ast->scope); break;
+        case AST_SET: return ast_r_scope(ast_copy_map(ast), ast->scope); break;
+        case AST_BITSET: return ast_r_scope(ast_copy_bitset(ast), ast->scope); break;
+        case AST_HEAP: return ast_r_scope(ast_copy_heap(ast), ast->scope); break;
+        case AST_BUILDER: return ast_r_scope(ast_copy_builder(ast), ast->scope); break;
+        // a reader is a position in a stream, copies read from the same position.
+        case AST_LINE_READER: return ast; break;
+        // copies write through the same buffer.
+        case AST_WRITER: return ast; break;
         default: printf("WARNING\n"); return (void*)0; break;
     }
 }
 
+/* ==== lists ==== */
+
+/**
+ * @param AST_T* ast a list
+ *
+ * @return size_t the number of items in the list
+ */
+size_t ast_list_size(AST_T* ast)
+{
+    return ast->typed_list ? ast->typed_list->size : ast->list_children->size;
+}
+
+/**
+ * Returns the item at `index` of a list, items of typed lists are boxed
+ * into a new node.
+ *
+ * @param AST_T* ast a list
+ * @param size_t index
+ *
+ * @return AST_T*
+ */
+AST_T* ast_list_get(AST_T* ast, size_t index)
+{
+    if (index >= ast_list_size(ast))
+    {
+        printf("Error: [Line %d] Index out of range\n", ast->line_n);
+        exit(1);
+    }
+
+    if (ast->typed_list)
+        return holyc_typed_list_box(ast->typed_list, index);
+
+    return (AST_T*) ast->list_children->items[index];
+}
+
+/**
+ * Appends items to a list.
+ * An empty list gets typed storage if the first item is a scalar, a typed
+ * list falls back to boxed items as soon as an item of another type is
+ * added.
+ *
+ * @param AST_T* ast a list
+ * @param void** items
+ * @param size_t items_size
+ */
+void ast_list_append_many(AST_T* ast, void** items, size_t items_size)
+{
+    size_t i = 0;
+
+    if (ast->typed_list == (void*)0 && ast->list_children->size == 0 && items_size > 0)
+    {
+        int type = holyc_typed_list_type_of((AST_T*) items[0]);
+
+        if (type)
+            ast->typed_list = init_holyc_typed_list(type);
+    }
+
+    if (ast->typed_list)
+    {
+        holyc_typed_list_reserve(ast->typed_list, ast->typed_list->size + items_size);
+
+        while (i < items_size && holyc_typed_list_append(ast->typed_list, (AST_T*) items[i]))
+            i++;
+
+        if (i == items_size)
+            return;
+
+        ast_list_unpack(ast);
+    }
+
+    for (size_t x = i; x < items_size; x++)
+        ast_share_value((AST_T*) items[x]);
+
+    dynamic_list_append_many(ast->list_children, &items[i], items_size - i);
+}
+
+/**
+ * Removes the item at `index` of a list, the index must be in range.
+ *
+ * @param AST_T* ast a list
+ * @param size_t index
+ */
+void ast_list_remove_at(AST_T* ast, size_t index)
+{
+    if (ast->typed_list)
+        holyc_typed_list_remove_at(ast->typed_list, index);
+    else
+        dynamic_list_remove_at(ast->list_children, index);
+}
+
+/**
+ * Returns a new list of the items from `start` up to but not including
+ * `end`. Typed lists share their items with the slice until one of them is
+ * mutated, boxed lists share the item nodes.
+ *
+ * @param AST_T* ast a list
+ * @param size_t start
+ * @param size_t end
+ *
+ * @return AST_T*
+ */
+AST_T* ast_list_slice(AST_T* ast, size_t start, size_t end)
+{
+    if (start > end || end > ast_list_size(ast))
+    {
+        printf("Error: [Line %d] Slice out of range\n", ast->line_n);
+        exit(1);
+    }
+
+    AST_T* slice = init_ast_with_line(AST_LIST, ast->line_n);
+    slice->scope = ast->scope;
+
+    if (ast->typed_list)
+        slice->typed_list = holyc_typed_list_slice(ast->typed_list, start, end);
+    else
+        dynamic_list_append_many(slice->list_children, &ast->list_children->items[start], end - start);
+
+    return slice;
+}
+
+/**
+ * Moves the items of a list literal into typed storage if they are all
+ * scalar literals of the same type.
+ *
+ * @param AST_T* ast a list
+ */
+void ast_list_pack(AST_T* ast)
+{
+    dynamic_list_T* children = ast->list_children;
+
+    if (ast->typed_list || children->size == 0)
+        return;
+
+    int type = holyc_typed_list_type_of((AST_T*) children->items[0]);
+
+    if (type == 0)
+        return;
+
+    for (size_t i = 1; i < children->size; i++)
+        if (holyc_typed_list_type_of((AST_T*) children->items[i]) != type)
+            return;
+
+    ast->typed_list = init_holyc_typed_list(type);
+    holyc_typed_list_reserve(ast->typed_list, children->size);
+
+    for (size_t i = 0; i < children->size; i++)
+        holyc_typed_list_append(ast->typed_list, (AST_T*) children->items[i]);
+
+    // the literals may still be referenced elsewhere, so they are not freed.
+    children->size = 0;
+}
+
+/**
+ * Moves the items of a typed list back into boxed nodes.
+ *
+ * @param AST_T* ast a list
+ */
+void ast_list_unpack(AST_T* ast)
+{
+    holyc_typed_list_T* typed_list = ast->typed_list;
+
+    if (typed_list == (void*)0)
+        return;
+
+    dynamic_list_reserve(ast->list_children, typed_list->size);
+
+    for (size_t i = 0; i < typed_list->size; i++)
+        dynamic_list_append(ast->list_children, holyc_typed_list_box(typed_list, i));
+
+    holyc_typed_list_free(typed_list);
+    ast->typed_list = (void*)0;
+}
+
+/* ==== strings ==== */
+
+/**
+ * Returns the header of the string of `ast`, or NULL if the string was not
+ * created with a header (strings of modules and of most builtins) or has
+ * been replaced since.
+ *
+ * @param AST_T* ast a string
+ *
+ * @return holyc_string_T*
+ */
+holyc_string_T* ast_string_header(AST_T* ast)
+{
+    holyc_string_T* header = ast->string_header;
+
+    return header && ast->string_value == header->data ? header : (void*)0;
+}
+
+/**
+ * Makes `string` the string of `ast`.
+ *
+ * @param AST_T* ast
+ * @param holyc_string_T* string
+ */
+void ast_string_set(AST_T* ast, holyc_string_T* string)
+{
+    ast->string_header = string;
+    ast->string_value = string->data;
+}
+
+/**
+ * Called when a value is given another name or stored in a list, a string
+ * that more than one place may refer to can not be changed in place
+ * anymore.
+ *
+ * @param AST_T* value
+ *
+ * @return AST_T* value
+ */
+AST_T* ast_share_value(AST_T* value)
+{
+    if (value && value->type == AST_STRING)
+    {
+        holyc_string_T* header = ast_string_header(value);
+
+        if (header)
+            header->unique = 0;
+    }
+
+    return value;
+}
+
+/**
+ * @param AST_T* ast a string
+ *
+ * @return size_t the length of the string, in constant time if it has a header
+ */
+size_t ast_string_length(AST_T* ast)
+{
+    holyc_string_T* header = ast_string_header(ast);
+
+    return header ? header->length : strlen(ast->string_value);
+}
+
+/**
+ * Compares two strings, strings of different lengths or with different
+ * hashes are told apart without comparing their chars.
+ *
+ * @param AST_T* a
+ * @param AST_T* b
+ *
+ * @return unsigned int
+ */
+unsigned int ast_string_equals(AST_T* a, AST_T* b)
+{
+    holyc_string_T* a_header = ast_string_header(a);
+    holyc_string_T* b_header = ast_string_header(b);
+
+    if (a_header == (void*)0 || b_header == (void*)0)
+        return strcmp(a->string_value, b->string_value) == 0;
+
+    if (a_header->length != b_header->length)
+        return 0;
+
+    // the hashes are cached, so comparing the same strings again is cheap.
+    if (holyc_string_hash(a_header) != holyc_string_hash(b_header))
+        return 0;
+
+    return memcmp(a_header->data, b_header->data, a_header->length) == 0;
+}
+
 /**
  * Converts an AST node to a memory allocated string.
  *
@@ -609,6 +1018,14 @@ char* ast_to_string(AST_T* ast)
         case AST_BREAK: return 0; break;
         case AST_RETURN: return ast_to_string(ast->return_value); break;
         case AST_ENUM: return ast_enum_to_string(ast); break;
+        case AST_DEQUE: return ast_deque_to_string(ast); break;
+        case AST_MAP: return ast_map_to_string(ast); break;
+        case AST_SET: return ast_set_to_string(ast); break;
+        case AST_BITSET: return ast_bitset_to_string(ast); break;
+        case AST_HEAP: return ast_heap_to_string(ast); break;
+        case AST_BUILDER: return ast_builder_to_string(ast); break;
+        case AST_LINE_READER: return ast_line_reader_to_string(ast); break;
+        case AST_WRITER: return ast_writer_to_string(ast); break;
         default: printf("Could not convert AST of type `%d` to string.\n", ast->type); return (void*)0; break;
     }
 
@@ -648,9 +1065,8 @@ char* ast_null_to_string(AST_T* ast)
 
 char* ast_float_to_string(AST_T* ast)
 {
-    const char* template = "%12.6f";
-    char* str = calloc(strlen(template) + 24, sizeof(char));
-    sprintf(str, template, ast->float_value);
+    char* str = calloc(HOLYC_FORMAT_BUFFER_SIZE, sizeof(char));
+    holyc_format_float_fixed(ast->float_value, str);
 
     return str;
 }
@@ -660,6 +1076,46 @@ char* ast_list_to_string(AST_T* ast)
     return holyc_init_str("[ list ]");
 }
 
+char* ast_deque_to_string(AST_T* ast)
+{
+    return holyc_init_str("[ deque ]");
+}
+
+char* ast_map_to_string(AST_T* ast)
+{
+    return holyc_init_str("{ map }");
+}
+
+char* ast_set_to_string(AST_T* ast)
+{
+    return holyc_init_str("{ set }");
+}
+
+char* ast_bitset_to_string(AST_T* ast)
+{
+    return holyc_init_str("[ bitset ]");
+}
+
+char* ast_heap_to_string(AST_T* ast)
+{
+    return holyc_init_str("[ heap ]");
+}
+
+char* ast_builder_to_string(AST_T* ast)
+{
+    return holyc_init_str("[ builder ]");
+}
+
+char* ast_line_reader_to_string(AST_T* ast)
+{
+    return holyc_init_str("[ lines ]");
+}
+
+char* ast_writer_to_string(AST_T* ast)
+{
+    return holyc_init_str("[ writer ]");
+}
+
 char* ast_boolean_to_string(AST_T* ast)
 {
     const char* template = "%d";
@@ -671,9 +1127,8 @@ char* ast_boolean_to_string(AST_T* ast)
 
 char* ast_integer_to_string(AST_T* ast)
 {
-    const char* template = "%d";
-    char* str = calloc(strlen(template) + 1, sizeof(char));
-    sprintf(str, template, ast->int_value ? ast->int_value : ast->long_int_value);
+    char* str = calloc(HOLYC_FORMAT_BUFFER_SIZE, sizeof(char));
+    holyc_format_i64(ast_int_value(ast), str);
 
     return str;
 }
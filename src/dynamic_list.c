@@ -1,13 +1,13 @@
-/**
- * TODO: add dynamic_list_remove method to remove items from list
- */
 #include "include/dynamic_list.h"
+#include <string.h>
+#include <stdio.h>
 
 
 /**
  * Creates a new list.
  * The item_size argument is used to define how big every item in the list
- * shall be.
+ * shall be. Items are always stored as pointers, the first
+ * DYNAMIC_LIST_INLINE_CAPACITY of them inside of the list itself.
  *
  * @param size_t item_size
  */
@@ -16,10 +16,53 @@ dynamic_list_T* init_dynamic_list(size_t item_size)
     dynamic_list_T* dynamic_list = calloc(1, sizeof(struct DYNAMIC_LIST_STRUCT));
     dynamic_list->item_size = item_size;
     dynamic_list->size = 0;
+    dynamic_list->items = dynamic_list->inline_items;
+    dynamic_list->capacity = DYNAMIC_LIST_INLINE_CAPACITY;
 
     return dynamic_list;
 }
 
+/**
+ * Makes sure that the list can hold at least `capacity` items without
+ * reallocating. The capacity grows geometrically.
+ *
+ * @param dynamic_list_T* dynamic_list
+ * @param size_t capacity
+ */
+void dynamic_list_reserve(dynamic_list_T* dynamic_list, size_t capacity)
+{
+    if (capacity <= dynamic_list->capacity)
+        return;
+
+    size_t new_capacity = dynamic_list->capacity * 2;
+
+    while (new_capacity < capacity)
+        new_capacity *= 2;
+
+    void** items;
+
+    if (dynamic_list->items == dynamic_list->inline_items)
+    {
+        items = malloc(new_capacity * sizeof(void*));
+
+        if (items)
+            memcpy(items, dynamic_list->inline_items, dynamic_list->size * sizeof(void*));
+    }
+    else
+    {
+        items = realloc(dynamic_list->items, new_capacity * sizeof(void*));
+    }
+
+    if (items == (void*)0)
+    {
+        printf("Error: Out of memory, could not grow list to %zu items\n", new_capacity);
+        exit(1);
+    }
+
+    dynamic_list->items = items;
+    dynamic_list->capacity = new_capacity;
+}
+
 /**
  * Appends and item to a dynamic_list
  *
@@ -30,56 +73,107 @@ dynamic_list_T* init_dynamic_list(size_t item_size)
  */
 void* dynamic_list_append(dynamic_list_T* dynamic_list, void* item)
 {
-    dynamic_list->size++;
-    dynamic_list->items = realloc(dynamic_list->items, (dynamic_list->size + 1) * dynamic_list->item_size);
-    dynamic_list->items[dynamic_list->size - 1] = item;
+    if (dynamic_list->size == dynamic_list->capacity)
+        dynamic_list_reserve(dynamic_list, dynamic_list->size + 1);
+
+    dynamic_list->items[dynamic_list->size++] = item;
+
+    return item;
+}
+
+/**
+ * Appends `items_size` items at once.
+ *
+ * @param dynamic_list_T* dynamic_list
+ * @param void** items
+ * @param size_t items_size
+ */
+void dynamic_list_append_many(dynamic_list_T* dynamic_list, void** items, size_t items_size)
+{
+    dynamic_list_reserve(dynamic_list, dynamic_list->size + items_size);
+    memcpy(&dynamic_list->items[dynamic_list->size], items, items_size * sizeof(void*));
+    dynamic_list->size += items_size;
+}
+
+/**
+ * Inserts an item at `index`, moving the following items one step right.
+ *
+ * @param dynamic_list_T* dynamic_list
+ * @param size_t index
+ * @param void* item
+ *
+ * @return void* item
+ */
+void* dynamic_list_insert(dynamic_list_T* dynamic_list, size_t index, void* item)
+{
+    if (index >= dynamic_list->size)
+        return dynamic_list_append(dynamic_list, item);
+
+    dynamic_list_reserve(dynamic_list, dynamic_list->size + 1);
+    memmove(&dynamic_list->items[index + 1], &dynamic_list->items[index], (dynamic_list->size - index) * sizeof(void*));
+    dynamic_list->items[index] = item;
+    dynamic_list->size += 1;
+
+    return item;
+}
+
+/**
+ * Removes the item at `index`, moving the following items one step left.
+ *
+ * @param dynamic_list_T* dynamic_list
+ * @param size_t index
+ *
+ * @return void* the removed item
+ */
+void* dynamic_list_remove_at(dynamic_list_T* dynamic_list, size_t index)
+{
+    if (index >= dynamic_list->size)
+        return (void*)0;
+
+    void* item = dynamic_list->items[index];
+
+    memmove(&dynamic_list->items[index], &dynamic_list->items[index + 1], (dynamic_list->size - index - 1) * sizeof(void*));
+    dynamic_list->size -= 1;
 
     return item;
 }
 
 /**
  * Use this to free / deallocate a dynamic_list.
+ * The items themselves are not freed.
  *
  * @param dynamic_list_T* dynamic_list
  */
 void dynamic_list_free(dynamic_list_T* dynamic_list)
 {
-    // silence
+    if (dynamic_list->items != dynamic_list->inline_items)
+        free(dynamic_list->items);
+
+    free(dynamic_list);
 }
 
 void dynamic_list_shift_left(dynamic_list_T* dynamic_list, int index)
 {
-   for (int i = index; i < dynamic_list->size - 1; i++)
-       dynamic_list->items[i] = dynamic_list->items[i + 1];
+    if (index < 0 || (size_t) index + 1 >= dynamic_list->size)
+        return;
+
+    memmove(&dynamic_list->items[index], &dynamic_list->items[index + 1], (dynamic_list->size - index - 1) * sizeof(void*));
 }
 
 void dynamic_list_remove(dynamic_list_T* dynamic_list, void* element, void (*free_method)(void* item))
 {
-    int index = 0;
-
     if (element == (void*)0)
         return;
 
-    for (int i = 0; i < dynamic_list->size; i++)
+    for (size_t i = 0; i < dynamic_list->size; i++)
     {
         if (dynamic_list->items[i] == element)
         {
-            index = i;
-            break;
-        }
-    }
+            if (free_method != (void*)0)
+                free_method(dynamic_list->items[i]);
 
-    if (free_method != (void*)0)    
-        free_method(dynamic_list->items[index]);
-
-    dynamic_list_shift_left(dynamic_list, index);  /* First shift the elements, then reallocate */
-    void *tmp = realloc(
-        dynamic_list->items, (dynamic_list->size - 1) * dynamic_list->item_size
-    );
-    if (tmp == NULL && dynamic_list->size > 1) {
-       /* No memory available */
-       exit(EXIT_FAILURE);
+            dynamic_list_remove_at(dynamic_list, i);
+            return;
+        }
     }
-    dynamic_list->size = dynamic_list->size - 1;
-    dynamic_list->items = tmp;
 }
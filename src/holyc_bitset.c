@@ -0,0 +1,156 @@
+#include "include/holyc_bitset.h"
+#include <string.h>
+#include <stdio.h>
+
+#define WORD_BITS 64
+
+
+#if defined(__GNUC__)
+#define popcount64(w) ((size_t) __builtin_popcountll(w))
+#define ctz64(w) ((size_t) __builtin_ctzll(w))
+#else
+static size_t popcount64(uint64_t w)
+{
+    w = w - ((w >> 1) & 0x5555555555555555ULL);
+    w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+    w = (w + (w >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+
+    return (size_t) ((w * 0x0101010101010101ULL) >> 56);
+}
+
+static size_t ctz64(uint64_t w)
+{
+    return popcount64((w & -w) - 1);
+}
+#endif
+
+/**
+ * Creates a bitset of `size` bits, all unset.
+ *
+ * @param size_t size
+ *
+ * @return holyc_bitset_T*
+ */
+holyc_bitset_T* init_holyc_bitset(size_t size)
+{
+    holyc_bitset_T* bitset = calloc(1, sizeof(struct holyc_BITSET_STRUCT));
+    bitset->size = size;
+    bitset->word_count = (size + WORD_BITS - 1) / WORD_BITS;
+    bitset->words = calloc(bitset->word_count ? bitset->word_count : 1, sizeof(uint64_t));
+
+    if (bitset->words == (void*)0)
+    {
+        printf("Error: Out of memory\n");
+        exit(1);
+    }
+
+    return bitset;
+}
+
+/* the index must be in range for these */
+
+void holyc_bitset_set(holyc_bitset_T* bitset, size_t index)
+{
+    bitset->words[index / WORD_BITS] |= (uint64_t) 1 << (index % WORD_BITS);
+}
+
+void holyc_bitset_unset(holyc_bitset_T* bitset, size_t index)
+{
+    bitset->words[index / WORD_BITS] &= ~((uint64_t) 1 << (index % WORD_BITS));
+}
+
+unsigned int holyc_bitset_test(holyc_bitset_T* bitset, size_t index)
+{
+    return (bitset->words[index / WORD_BITS] >> (index % WORD_BITS)) & 1;
+}
+
+/**
+ * @param holyc_bitset_T* bitset
+ *
+ * @return size_t the number of set bits
+ */
+size_t holyc_bitset_count(holyc_bitset_T* bitset)
+{
+    size_t count = 0;
+
+    for (size_t i = 0; i < bitset->word_count; i++)
+        count += popcount64(bitset->words[i]);
+
+    return count;
+}
+
+/**
+ * Finds the first set bit at or after `index`, skipping whole words of
+ * unset bits.
+ *
+ * @param holyc_bitset_T* bitset
+ * @param size_t index
+ *
+ * @return size_t the index of the bit, or the size of the bitset if there is none
+ */
+size_t holyc_bitset_next(holyc_bitset_T* bitset, size_t index)
+{
+    if (index >= bitset->size)
+        return bitset->size;
+
+    size_t w = index / WORD_BITS;
+    uint64_t word = bitset->words[w] & (~(uint64_t) 0 << (index % WORD_BITS));
+
+    while (word == 0)
+    {
+        if (++w >= bitset->word_count)
+            return bitset->size;
+
+        word = bitset->words[w];
+    }
+
+    return w * WORD_BITS + ctz64(word);
+}
+
+/* both bitsets must be of the same size */
+
+holyc_bitset_T* holyc_bitset_union(holyc_bitset_T* a, holyc_bitset_T* b)
+{
+    holyc_bitset_T* result = init_holyc_bitset(a->size);
+
+    for (size_t i = 0; i < a->word_count; i++)
+        result->words[i] = a->words[i] | b->words[i];
+
+    return result;
+}
+
+holyc_bitset_T* holyc_bitset_intersection(holyc_bitset_T* a, holyc_bitset_T* b)
+{
+    holyc_bitset_T* result = init_holyc_bitset(a->size);
+
+    for (size_t i = 0; i < a->word_count; i++)
+        result->words[i] = a->words[i] & b->words[i];
+
+    return result;
+}
+
+/**
+ * @param holyc_bitset_T* bitset
+ *
+ * @return holyc_bitset_T*
+ */
+holyc_bitset_T* holyc_bitset_copy(holyc_bitset_T* bitset)
+{
+    holyc_bitset_T* copy = init_holyc_bitset(bitset->size);
+
+    if (bitset->word_count)
+        memcpy(copy->words, bitset->words, bitset->word_count * sizeof(uint64_t));
+
+    return copy;
+}
+
+/**
+ * Deallocates a bitset.
+ *
+ * @param holyc_bitset_T* bitset
+ */
+void holyc_bitset_free(holyc_bitset_T* bitset)
+{
+    free(bitset->words);
+    free(bitset);
+}
@@ -1,12 +1,25 @@
+#define _POSIX_C_SOURCE 200809L
 #include "include/holyc_builtins.h"
 #include "include/holyc_runtime.h"
 #include "include/holyc_lexer.h"
 #include "include/holyc_parser.h"
+#include "include/holyc_module.h"
+#include "include/holyc_include_cache.h"
+#include "include/holyc_typed_list.h"
+#include "include/holyc_kernels.h"
+#include "include/holyc_bitset.h"
+#include "include/holyc_heap.h"
+#include "include/holyc_output.h"
+#include "include/holyc_line_reader.h"
+#include "include/holyc_string.h"
 #include "include/string_utils.h"
 #include "include/io.h"
 #include "include/dl.h"
 #include <string.h>
 #include <time.h>
+#include <unistd.h>
+
+AST_T* INITIALIZED_NOOP;
 
 void init_builtins(runtime_T* runtime)
 {
@@ -14,10 +27,13 @@ void init_builtins(runtime_T* runtime)
 
   // GLOBAL FUNCTIONS
   runtime_register_global_function(runtime, "include", holyc_builtin_function_include);
+  runtime_register_global_function(runtime, "include_prewarm", holyc_builtin_function_include_prewarm);
   runtime_register_global_function(runtime, "wad", holyc_builtin_function_wad);
   runtime_register_global_function(runtime, "lad", holyc_builtin_function_lad);
   runtime_register_global_function(runtime, "print", holyc_builtin_function_print);
   runtime_register_global_function(runtime, "stdoutbuffer", holyc_builtin_function_stdoutbuffer);
+  runtime_register_global_function(runtime, "flush", holyc_builtin_function_flush);
+  runtime_register_global_function(runtime, "stdout_mode", holyc_builtin_function_stdout_mode);
   runtime_register_global_function(runtime, "aprint", holyc_builtin_function_aprint);
   runtime_register_global_function(runtime, "fopen", holyc_builtin_function_fopen);
   runtime_register_global_function(runtime, "fclose", holyc_builtin_function_fclose);
@@ -32,6 +48,23 @@ void init_builtins(runtime_T* runtime)
   runtime_register_global_function(runtime, "free", holyc_builtin_function_free);
   runtime_register_global_function(runtime, "visit", holyc_builtin_function_visit);
   runtime_register_global_function(runtime, "strrev", holyc_builtin_function_strrev);
+
+  // NUMERIC LIST FUNCTIONS
+  runtime_register_global_function(runtime, "sum", holyc_builtin_function_sum);
+  runtime_register_global_function(runtime, "min", holyc_builtin_function_min);
+  runtime_register_global_function(runtime, "max", holyc_builtin_function_max);
+  runtime_register_global_function(runtime, "mean", holyc_builtin_function_mean);
+  runtime_register_global_function(runtime, "dot", holyc_builtin_function_dot);
+  runtime_register_global_function(runtime, "axpy", holyc_builtin_function_axpy);
+  runtime_register_global_function(runtime, "scale", holyc_builtin_function_scale);
+  runtime_register_global_function(runtime, "vadd", holyc_builtin_function_vadd);
+  runtime_register_global_function(runtime, "vmul", holyc_builtin_function_vmul);
+  runtime_register_global_function(runtime, "cumsum", holyc_builtin_function_cumsum);
+
+  // CONTAINER FUNCTIONS
+  runtime_register_global_function(runtime, "bitset", holyc_builtin_function_bitset);
+  runtime_register_global_function(runtime, "heap", holyc_builtin_function_heap);
+  runtime_register_global_function(runtime, "writer", holyc_builtin_function_writer);
 }
 
 /**
@@ -46,18 +79,8 @@ AST_T* holyc_builtin_function_print(runtime_T* runtime, AST_T* self, dynamic_lis
 {
     for (int i = 0; i < args->size; i++)
     {
-        AST_T* ast_arg = (AST_T*) args->items[i];
-        char* str = ast_to_string(ast_arg);
-
-        if (str == (void*)0)
-        {
-            printf("(void*)0\n");
-        }
-        else
-        {
-            printf("%s\n", str);
-            free(str);
-        }
+        holyc_output_write_value(runtime->output, (AST_T*) args->items[i]);
+        holyc_output_write(runtime->output, "\n", 1);
     }
 
     return INITIALIZED_NOOP;
@@ -76,9 +99,8 @@ AST_T* holyc_builtin_function_stdoutbuffer(runtime_T* runtime, AST_T* self, dyna
         }
         else
         {
-            str = realloc(str, (strlen(str) + 2) * sizeof(char));
-            strcat(str, "\n");
             holyc_runtime_buffer_stdout(runtime, str);
+            holyc_runtime_buffer_stdout(runtime, "\n");
             free(str);
         }
     }
@@ -86,6 +108,61 @@ AST_T* holyc_builtin_function_stdoutbuffer(runtime_T* runtime, AST_T* self, dyna
     return INITIALIZED_NOOP;
 }
 
+/**
+ * Writes everything printed so far to stdout.
+ *
+ * @param AST_T* self
+ * @param dynamic_list_T* args
+ *
+ * @return AST_T*
+ */
+AST_T* holyc_builtin_function_flush(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    holyc_output_flush(runtime->output);
+
+    return INITIALIZED_NOOP;
+}
+
+/**
+ * Chooses when stdout is flushed, "line" writes every printed line right
+ * away and "full" only when the buffer is full, on flush() or on exit.
+ *
+ * @param AST_T* self
+ * @param dynamic_list_T* args
+ *
+ * @return AST_T*
+ */
+AST_T* holyc_builtin_function_stdout_mode(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    runtime_expect_args(args, 1, (int[]) {AST_STRING});
+
+    const char* mode_name = ((AST_T*) args->items[0])->string_value;
+    int mode = 0;
+
+    if (strcmp(mode_name, "line") == 0)
+        mode = HOLYC_OUTPUT_LINE_BUFFERED;
+    else
+    if (strcmp(mode_name, "full") == 0)
+        mode = HOLYC_OUTPUT_FULLY_BUFFERED;
+
+    if (mode == 0)
+    {
+        printf("Error: stdout_mode() expects \"line\" or \"full\" but got `%s`\n", mode_name);
+        exit(1);
+    }
+
+    // stdio does not allow replacing the buffer once stdout has been used.
+    if (args->size > 1)
+    {
+        printf("Error: stdout_mode() only takes a mode, the size of the buffer is fixed at startup\n");
+        exit(1);
+    }
+
+    holyc_output_set_mode(runtime->output, mode);
+
+    return INITIALIZED_NOOP;
+}
+
 /**
  * Print the adress of a value
  *
@@ -104,7 +181,7 @@ AST_T* holyc_builtin_function_aprint(runtime_T* runtime, AST_T* self, dynamic_li
 
 /**
  * Method for including other scripts, this will return the root node
- * as a compound.
+ * as a compound. Parsed scripts are cached, see holyc_include_cache.h
  *
  * @param AST_T* self
  * @param dynamic_list_T* args
@@ -118,17 +195,33 @@ AST_T* holyc_builtin_function_include(runtime_T* runtime, AST_T* self, dynamic_l
     AST_T* ast_str = (AST_T*) args->items[0];
     char* filename = ast_str->string_value;
 
-    holyc_lexer_T* lexer = init_holyc_lexer(holyc_read_file(filename));
-    holyc_parser_T* parser = init_holyc_parser(lexer);
-    AST_T* node = holyc_parser_parse(parser, (void*) 0);
+    return runtime_run_include(runtime, holyc_include_cache_get(runtime->include_cache, filename));
+}
 
-    holyc_lexer_free(lexer);
+/**
+ * Parses every file listed in a manifest into the include cache, so that
+ * later include() calls of those files do not have to parse them.
+ *
+ * @param AST_T* self
+ * @param dynamic_list_T* args
+ *
+ * @return AST_T* the number of files listed
+ */
+AST_T* holyc_builtin_function_include_prewarm(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    runtime_expect_args(args, 1, (int[]) {AST_STRING});
+
+    AST_T* ast_str = (AST_T*) args->items[0];
+
+    AST_T* ast_int = init_ast(AST_INTEGER);
+    ast_int->int_value = holyc_include_cache_prewarm(runtime->include_cache, ast_str->string_value);
 
-    return node;
+    return ast_int;
 }
 
 /**
- * Builtin method to dump an AST node to disk, serialized.
+ * Builtin method to dump an AST node to disk as a module,
+ * see holyc_module.h.
  *
  * @param AST_T* self
  * @param dynamic_list_T* args
@@ -144,42 +237,19 @@ AST_T* holyc_builtin_function_wad(runtime_T* runtime, AST_T* self, dynamic_list_
 
     char* filename = ast_string->string_value;
 
-    FILE *outfile;
-
     const char* filename_template = "%s.dat";
     char* fname = calloc(strlen(filename) + strlen(filename_template) + 1, sizeof(char));
     sprintf(fname, filename_template, filename);
 
-    outfile = fopen(fname, "w");
-
-    if (outfile == NULL)
-    {
-        fprintf(stderr, "Could not open %s\n", fname);
-        free(fname);
-        exit(1);
-    }
-
-    // write struct to file
-    int r = fwrite (&*ast_compound, sizeof(struct AST_STRUCT), 1, outfile);
-
-    if(r != 0)
-    {
-        // silence
-    }
-    else
-    {
-        printf("Could not write to %s\n", fname);
-    }
+    holyc_module_write(ast_compound, fname);
 
     free(fname);
 
-    fclose(outfile);
-
     return ast_compound;
 }
 
 /**
- * Built-in function to load a compound AST from disk
+ * Built-in function to load a compound AST from a module on disk
  *
  * @param AST_T* self
  * @param dynamic_list_T* args
@@ -198,27 +268,89 @@ AST_T* holyc_builtin_function_lad(runtime_T* runtime, AST_T* self, dynamic_list_
     char* fname = calloc(strlen(filename) + strlen(filename_template) + 1, sizeof(char));
     sprintf(fname, filename_template, filename);
 
-    FILE *infile;
-    struct AST_STRUCT input;
+    AST_T* loaded = holyc_module_load(fname);
+
+    free(fname);
+
+    return loaded;
+}
+
+/**
+ * Returns the contents of the file as a read only string backed by the
+ * file itself, pages are only read once they are accessed.
+ */
+static AST_T* object_file_function_map(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    FILE* f = self->object_value;
+    holyc_string_T* string = f ? holyc_string_map_file(fileno(f)) : (void*)0;
 
-    infile = fopen(fname, "r");
-    if (infile == NULL)
+    if (string == (void*)0)
     {
-        fprintf(stderr, "Error reading %s\n", fname);
-        free(fname);
+        printf("Error: map() of a file that can not be mapped\n");
         exit(1);
     }
 
-    // read file contents till end of file
-    while(fread(&input, sizeof(struct AST_STRUCT), 1, infile))
-        printf("...\n");
+    AST_T* ast_string = init_ast(AST_STRING);
+    ast_string_set(ast_string, string);
+
+    return ast_string;
+}
+
+/**
+ * Returns the buffer size given as the argument at `index`, or 0 for the
+ * default size if there is none.
+ */
+static size_t writer_size_arg(const char* fname, dynamic_list_T* args, size_t index)
+{
+    if (args->size <= index)
+        return 0;
 
-    // close file
-    fclose (infile);
+    AST_T* ast_size = (AST_T*) args->items[index];
 
-    AST_T* loaded = &input;
+    if (ast_size->type != AST_INTEGER || ast_size->int_value <= 0)
+    {
+        printf("Error: %s() expects a positive buffer size\n", fname);
+        exit(1);
+    }
 
-    return loaded;
+    return (size_t) ast_size->int_value;
+}
+
+/**
+ * Returns a writer of the file with a buffer of its own, the buffer of
+ * the file is flushed first so that nothing is written out of order.
+ * The writer has its own file descriptor, closing it does not close
+ * the file.
+ */
+static AST_T* object_file_function_writer(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    FILE* f = self->object_value;
+    int fd = -1;
+
+    if (f)
+    {
+        fflush(f);
+        fd = dup(fileno(f));
+    }
+
+    if (fd < 0)
+    {
+        printf("Error: writer() of a file that can not be written\n");
+        exit(1);
+    }
+
+    return runtime_init_writer(runtime, fd, writer_size_arg("writer", args, 0), 1);
+}
+
+/**
+ * Returns a reader of the lines of the file from its current position,
+ * to be iterated or read with next().
+ */
+static AST_T* object_file_function_lines(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    FILE* f = self->object_value;
+
+    return runtime_init_line_reader(runtime, f ? fileno(f) : -1);
 }
 
 static AST_T* object_file_function_read(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
@@ -233,7 +365,7 @@ static AST_T* object_file_function_read(runtime_T* runtime, AST_T* self, dynamic
         fseek (f, 0, SEEK_END);
         length = ftell (f);
         fseek (f, 0, SEEK_SET);
-        buffer = calloc (length, length);
+        buffer = calloc (length + 1, sizeof(char));
 
         if (buffer)
             fread (buffer, 1, length, f);
@@ -271,8 +403,23 @@ AST_T* holyc_builtin_function_fopen(runtime_T* runtime, AST_T* self, dynamic_lis
     fdef_read->function_name = "read";
     fdef_read->fptr = object_file_function_read;
 
+    AST_T* fdef_lines = init_ast(AST_FUNCTION_DEFINITION);
+    fdef_lines->function_name = "lines";
+    fdef_lines->fptr = object_file_function_lines;
+
+    AST_T* fdef_map = init_ast(AST_FUNCTION_DEFINITION);
+    fdef_map->function_name = "map";
+    fdef_map->fptr = object_file_function_map;
+
+    AST_T* fdef_writer = init_ast(AST_FUNCTION_DEFINITION);
+    fdef_writer->function_name = "writer";
+    fdef_writer->fptr = object_file_function_writer;
+
     ast_obj->function_definitions = init_dynamic_list(sizeof(struct AST_STRUCT*));
     dynamic_list_append(ast_obj->function_definitions, fdef_read);
+    dynamic_list_append(ast_obj->function_definitions, fdef_lines);
+    dynamic_list_append(ast_obj->function_definitions, fdef_map);
+    dynamic_list_append(ast_obj->function_definitions, fdef_writer);
 
     return ast_obj;
 }
@@ -330,49 +477,18 @@ AST_T* holyc_builtin_function_fputs(runtime_T* runtime, AST_T* self, dynamic_lis
  */
 AST_T* holyc_builtin_function_input(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
 {
-    char* str;
-    int c;
-    int i;
-    int size = 10;
-
-    str = malloc(size * sizeof(char));
-
     if (args->size > 0)
         printf("%s", ((AST_T*)args->items[0])->string_value);
 
-    for(i = 0; (c = getchar()) != '\n' && c != EOF; ++i)
-    {
-        if(i == size)
-        {
-            size = 2*size;
-            str = realloc(str, size*sizeof(char));
-
-            if(str == NULL)
-            {
-                printf("Cannot reallic string.\n");
-                exit(-1);
-            }
-        }
-
-        str[i] = c;
-    }
-
-    if(i == size)
-    {
-        str = realloc(str, (size+1)*sizeof(char));
-
-        if(str == NULL)
-        {
-            printf("Cannot realloc string.\n");
-            exit(-1);
-        }
-
-    }
+    // the prompt would otherwise wait in the buffer when it is not line buffered.
+    holyc_output_flush(runtime->output);
 
-    str[i] = '\0';
+    // reads through the same buffer as iterating stdin, so no input is skipped.
+    size_t length = 0;
+    const char* line = holyc_line_reader_next((holyc_line_reader_T*) runtime->stdin_reader->object_value, &length);
 
     AST_T* ast = init_ast(AST_STRING);
-    ast->string_value = str;
+    ast_string_set(ast, init_holyc_string(line, line ? length : 0));
 
     return ast;
 }
@@ -570,13 +686,434 @@ AST_T* holyc_builtin_function_strrev(runtime_T* runtime, AST_T* self, dynamic_li
 {
     runtime_expect_args(args, 1, (int[]) {AST_STRING});
 
-    char* input_string = ((AST_T*)args->items[0])->string_value;
-
-    char* new_str = holyc_strrev(input_string);
+    AST_T* input_string = (AST_T*) args->items[0];
 
+    // reverses a copy, the argument may be shared or read only.
     AST_T* ast_string = init_ast(AST_STRING);
-    ast_string->string_value = calloc(strlen(new_str) + 1, sizeof(char));
-    strcpy(ast_string->string_value, new_str);
+    ast_string_set(ast_string, init_holyc_string(input_string->string_value, ast_string_length(input_string)));
+    holyc_strrev(ast_string->string_value);
 
     return ast_string;
 }
+
+/* ==== numeric lists ==== */
+
+static holyc_typed_list_T EMPTY_NUMERIC_LIST = { HOLYC_TYPED_LIST_INT, sizeof(int64_t), 0, 0, (void*)0 };
+
+/**
+ * Returns the unboxed items of the list argument at `index`, lists of
+ * boxed numbers of a single type are unboxed first.
+ */
+static holyc_typed_list_T* numeric_list_arg(dynamic_list_T* args, size_t index, const char* fname)
+{
+    AST_T* ast = index < args->size ? (AST_T*) args->items[index] : (void*)0;
+
+    if (ast == (void*)0 || ast->type != AST_LIST)
+    {
+        printf("Error: %s() expects a list as argument %d\n", fname, (int) index + 1);
+        exit(1);
+    }
+
+    ast_list_pack(ast);
+
+    if (ast->typed_list == (void*)0 && ast->list_children->size == 0)
+        return &EMPTY_NUMERIC_LIST;
+
+    if (ast->typed_list == (void*)0 || ast->typed_list->type == HOLYC_TYPED_LIST_CHAR)
+    {
+        printf("Error: [Line %d] %s() expects a list of only ints or only floats\n", ast->line_n, fname);
+        exit(1);
+    }
+
+    return ast->typed_list;
+}
+
+/**
+ * Returns the unboxed items of the two list arguments at `index` and
+ * `index + 1`, which must be of the same type and length.
+ */
+static void numeric_list_args(dynamic_list_T* args, size_t index, const char* fname, holyc_typed_list_T** x, holyc_typed_list_T** y)
+{
+    *x = numeric_list_arg(args, index, fname);
+    *y = numeric_list_arg(args, index + 1, fname);
+
+    if ((*x)->size != (*y)->size || ((*x)->size && (*x)->type != (*y)->type))
+    {
+        printf("Error: %s() expects two lists of the same type and length\n", fname);
+        exit(1);
+    }
+}
+
+static AST_T* numeric_result(int type, int64_t int_value, double float_value)
+{
+    AST_T* ast;
+
+    if (type == HOLYC_TYPED_LIST_FLOAT)
+    {
+        ast = init_ast(AST_FLOAT);
+        ast->float_value = (float) float_value;
+    }
+    else
+    {
+        ast = init_ast(AST_INTEGER);
+        ast_set_int_value(ast, int_value);
+    }
+
+    return ast;
+}
+
+static AST_T* numeric_list_result(runtime_T* runtime, holyc_typed_list_T* typed_list)
+{
+    AST_T* ast = init_ast(AST_LIST);
+    ast->typed_list = typed_list;
+    ast->function_definitions = runtime->list_methods;
+
+    return ast;
+}
+
+/**
+ * Creates an uninitialized typed list of `size` items.
+ */
+static holyc_typed_list_T* numeric_list_alloc(int type, size_t size)
+{
+    holyc_typed_list_T* typed_list = init_holyc_typed_list(type);
+    holyc_typed_list_reserve(typed_list, size);
+    typed_list->size = size;
+
+    return typed_list;
+}
+
+static void expect_not_empty(holyc_typed_list_T* typed_list, const char* fname)
+{
+    if (typed_list->size == 0)
+    {
+        printf("Error: %s() of an empty list\n", fname);
+        exit(1);
+    }
+}
+
+/**
+ * sum(list), the sum of a list of ints or floats.
+ *
+ * @param AST_T* self
+ * @param dynamic_list_T* args
+ *
+ * @return AST_T*
+ */
+AST_T* holyc_builtin_function_sum(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    holyc_typed_list_T* x = numeric_list_arg(args, 0, "sum");
+
+    if (x->type == HOLYC_TYPED_LIST_FLOAT)
+        return numeric_result(x->type, 0, holyc_kernel_sum_f64(x->data, x->size));
+
+    return numeric_result(x->type, holyc_kernel_sum_i64(x->data, x->size), 0);
+}
+
+/**
+ * min(list), the smallest item of a non empty list of ints or floats.
+ *
+ * @param AST_T* self
+ * @param dynamic_list_T* args
+ *
+ * @return AST_T*
+ */
+AST_T* holyc_builtin_function_min(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    holyc_typed_list_T* x = numeric_list_arg(args, 0, "min");
+    expect_not_empty(x, "min");
+
+    if (x->type == HOLYC_TYPED_LIST_FLOAT)
+        return numeric_result(x->type, 0, holyc_kernel_min_f64(x->data, x->size));
+
+    return numeric_result(x->type, holyc_kernel_min_i64(x->data, x->size), 0);
+}
+
+/**
+ * max(list), the largest item of a non empty list of ints or floats.
+ *
+ * @param AST_T* self
+ * @param dynamic_list_T* args
+ *
+ * @return AST_T*
+ */
+AST_T* holyc_builtin_function_max(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    holyc_typed_list_T* x = numeric_list_arg(args, 0, "max");
+    expect_not_empty(x, "max");
+
+    if (x->type == HOLYC_TYPED_LIST_FLOAT)
+        return numeric_result(x->type, 0, holyc_kernel_max_f64(x->data, x->size));
+
+    return numeric_result(x->type, holyc_kernel_max_i64(x->data, x->size), 0);
+}
+
+/**
+ * mean(list), the average of a non empty list of ints or floats, always
+ * a float.
+ *
+ * @param AST_T* self
+ * @param dynamic_list_T* args
+ *
+ * @return AST_T*
+ */
+AST_T* holyc_builtin_function_mean(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    holyc_typed_list_T* x = numeric_list_arg(args, 0, "mean");
+    expect_not_empty(x, "mean");
+
+    double sum = x->type == HOLYC_TYPED_LIST_FLOAT ?
+        holyc_kernel_sum_f64(x->data, x->size) :
+        (double) holyc_kernel_sum_i64(x->data, x->size);
+
+    return numeric_result(HOLYC_TYPED_LIST_FLOAT, 0, sum / (double) x->size);
+}
+
+/**
+ * dot(a, b), the dot product of two lists of the same type and length.
+ *
+ * @param AST_T* self
+ * @param dynamic_list_T* args
+ *
+ * @return AST_T*
+ */
+AST_T* holyc_builtin_function_dot(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    holyc_typed_list_T* x;
+    holyc_typed_list_T* y;
+    numeric_list_args(args, 0, "dot", &x, &y);
+
+    if (x->type == HOLYC_TYPED_LIST_FLOAT)
+        return numeric_result(x->type, 0, holyc_kernel_dot_f64(x->data, y->data, x->size));
+
+    return numeric_result(x->type, holyc_kernel_dot_i64(x->data, y->data, x->size), 0);
+}
+
+/**
+ * axpy(a, x, y), computes y = a * x + y in place and returns y.
+ * `a` has to be an int if the lists are lists of ints.
+ *
+ * @param AST_T* self
+ * @param dynamic_list_T* args
+ *
+ * @return AST_T*
+ */
+AST_T* holyc_builtin_function_axpy(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    runtime_expect_args(args, 3, (int[]){ AST_ANY, AST_LIST, AST_LIST });
+
+    AST_T* a = (AST_T*) args->items[0];
+    holyc_typed_list_T* x;
+    holyc_typed_list_T* y;
+    numeric_list_args(args, 1, "axpy", &x, &y);
+
+    if (x->size == 0)
+        return (AST_T*) args->items[2];
+
+    // y may share its items with a slice or a copy.
+    void* y_data = holyc_typed_list_mutable_data(y);
+
+    if (x->type == HOLYC_TYPED_LIST_FLOAT && (a->type == AST_FLOAT || a->type == AST_INTEGER))
+        holyc_kernel_axpy_f64(a->type == AST_FLOAT ? a->float_value : a->int_value, x->data, y_data, x->size);
+    else
+    if (x->type == HOLYC_TYPED_LIST_INT && a->type == AST_INTEGER)
+        holyc_kernel_axpy_i64(ast_int_value(a), x->data, y_data, x->size);
+    else
+    {
+        printf("Error: axpy() expects a number of the type of the lists\n");
+        exit(1);
+    }
+
+    return (AST_T*) args->items[2];
+}
+
+/**
+ * scale(list, k), a new list with every item multiplied by `k`.
+ *
+ * @param AST_T* self
+ * @param dynamic_list_T* args
+ *
+ * @return AST_T*
+ */
+AST_T* holyc_builtin_function_scale(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    runtime_expect_args(args, 2, (int[]){ AST_LIST, AST_ANY });
+
+    holyc_typed_list_T* x = numeric_list_arg(args, 0, "scale");
+    AST_T* k = (AST_T*) args->items[1];
+
+    holyc_typed_list_T* out = numeric_list_alloc(x->type, x->size);
+
+    if (x->size)
+        memset(out->data, 0, x->size * x->item_size);
+
+    // scaling is axpy into zeros.
+    if (x->type == HOLYC_TYPED_LIST_FLOAT && (k->type == AST_FLOAT || k->type == AST_INTEGER))
+        holyc_kernel_axpy_f64(k->type == AST_FLOAT ? k->float_value : k->int_value, x->data, out->data, x->size);
+    else
+    if (x->type == HOLYC_TYPED_LIST_INT && k->type == AST_INTEGER)
+        holyc_kernel_axpy_i64(ast_int_value(k), x->data, out->data, x->size);
+    else
+    {
+        printf("Error: scale() expects a number of the type of the list\n");
+        exit(1);
+    }
+
+    return numeric_list_result(runtime, out);
+}
+
+/**
+ * vadd(a, b), a new list with the sums of the items of two lists of the
+ * same type and length.
+ *
+ * @param AST_T* self
+ * @param dynamic_list_T* args
+ *
+ * @return AST_T*
+ */
+AST_T* holyc_builtin_function_vadd(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    holyc_typed_list_T* x;
+    holyc_typed_list_T* y;
+    numeric_list_args(args, 0, "vadd", &x, &y);
+
+    holyc_typed_list_T* out = numeric_list_alloc(x->type, x->size);
+
+    if (x->type == HOLYC_TYPED_LIST_FLOAT)
+        holyc_kernel_add_f64(x->data, y->data, out->data, x->size);
+    else
+        holyc_kernel_add_i64(x->data, y->data, out->data, x->size);
+
+    return numeric_list_result(runtime, out);
+}
+
+/**
+ * vmul(a, b), a new list with the products of the items of two lists of
+ * the same type and length.
+ *
+ * @param AST_T* self
+ * @param dynamic_list_T* args
+ *
+ * @return AST_T*
+ */
+AST_T* holyc_builtin_function_vmul(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    holyc_typed_list_T* x;
+    holyc_typed_list_T* y;
+    numeric_list_args(args, 0, "vmul", &x, &y);
+
+    holyc_typed_list_T* out = numeric_list_alloc(x->type, x->size);
+
+    if (x->type == HOLYC_TYPED_LIST_FLOAT)
+        holyc_kernel_mul_f64(x->data, y->data, out->data, x->size);
+    else
+        holyc_kernel_mul_i64(x->data, y->data, out->data, x->size);
+
+    return numeric_list_result(runtime, out);
+}
+
+/**
+ * cumsum(list), a new list with the running sums of a list.
+ *
+ * @param AST_T* self
+ * @param dynamic_list_T* args
+ *
+ * @return AST_T*
+ */
+AST_T* holyc_builtin_function_cumsum(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    holyc_typed_list_T* x = numeric_list_arg(args, 0, "cumsum");
+    holyc_typed_list_T* out = numeric_list_alloc(x->type, x->size);
+
+    if (x->type == HOLYC_TYPED_LIST_FLOAT)
+        holyc_kernel_cumsum_f64(x->data, out->data, x->size);
+    else
+        holyc_kernel_cumsum_i64(x->data, out->data, x->size);
+
+    return numeric_list_result(runtime, out);
+}
+
+/**
+ * bitset(size), a new bitset of `size` unset bits.
+ *
+ * @param AST_T* self
+ * @param dynamic_list_T* args
+ *
+ * @return AST_T*
+ */
+AST_T* holyc_builtin_function_bitset(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    runtime_expect_args(args, 1, (int[]){ AST_INTEGER });
+
+    int size = ((AST_T*) args->items[0])->int_value;
+
+    if (size < 0)
+    {
+        printf("Error: bitset() of a negative size\n");
+        exit(1);
+    }
+
+    AST_T* ast = init_ast(AST_BITSET);
+    ast->object_value = init_holyc_bitset(size);
+    ast->function_definitions = runtime->bitset_methods;
+
+    return ast;
+}
+
+/**
+ * heap(), or heap(comparator), a new empty heap. Without a comparator ints,
+ * floats and strings are popped smallest first.
+ *
+ * @param AST_T* self
+ * @param dynamic_list_T* args
+ *
+ * @return AST_T*
+ */
+AST_T* holyc_builtin_function_heap(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    holyc_heap_T* heap = (void*)0;
+
+    if (args->size > 0)
+    {
+        runtime_expect_args(args, 1, (int[]){ AST_FUNCTION_DEFINITION });
+
+        runtime_comparator_T* comparator = init_runtime_comparator(runtime, (AST_T*) args->items[0]);
+        heap = init_holyc_heap(runtime_comparator_less, comparator);
+    }
+    else
+        heap = init_holyc_heap((void*)0, (void*)0);
+
+    AST_T* ast = init_ast(AST_HEAP);
+    ast->object_value = heap;
+    ast->function_definitions = runtime->heap_methods;
+
+    return ast;
+}
+
+/**
+ * Built-in function to create a buffered writer of a file descriptor,
+ * e.g writer(1) for stdout. The size of the buffer can be given as a
+ * second argument. Printed output is flushed first, the file descriptor
+ * is not closed when the writer is.
+ *
+ * @param AST_T* self
+ * @param dynamic_list_T* args
+ *
+ * @return AST_T*
+ */
+AST_T* holyc_builtin_function_writer(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    runtime_expect_args(args, 1, (int[]){ AST_INTEGER });
+
+    int fd = ((AST_T*) args->items[0])->int_value;
+
+    if (fd < 0)
+    {
+        printf("Error: writer() expects a file descriptor but got `%d`\n", fd);
+        exit(1);
+    }
+
+    holyc_output_flush(runtime->output);
+
+    return runtime_init_writer(runtime, fd, writer_size_arg("writer", args, 1), 0);
+}
@@ -1,34 +1,18 @@
 #include "include/holyc_cleanup.h"
+#include "include/holyc_include_cache.h"
+#include "include/holyc_output.h"
+#include "include/holyc_string.h"
+#include "include/holyc_line_reader.h"
 
 
 /**
- * Clean & deallocate holyc
+ * Deallocates a list of native methods and their definitions.
  */
-void holyc_cleanup(
-    holyc_lexer_T* holyc_lexer,
-    holyc_parser_T* parser,
-    runtime_T* runtime,
-    AST_T* node
-)
+static void free_methods(dynamic_list_T* methods)
 {
-    ast_free(node);
-
-    if (parser->current_token)
-        token_free(parser->current_token);
-
-    if (parser->prev_token)
-        token_free(parser->prev_token);
-
-    free(parser);
-
-    holyc_lexer_free(holyc_lexer);
-    //holyc_scope_free(runtime->scope);
-    
-    /* ==== Free definitions ==== */
-
-    for (int i = 0; i < runtime->list_methods->size; i++)
+    for (int i = 0; i < methods->size; i++)
     {
-        AST_T* fdef = (AST_T*) runtime->list_methods->items[i];
+        AST_T* fdef = (AST_T*) methods->items[i];
 
         if (fdef->function_definition_type)
             ast_free(fdef->function_definition_type);
@@ -47,8 +31,7 @@ void holyc_cleanup(
                     ast_free((AST_T*)fdef->function_definition_arguments->items[x]);
             }
 
-            free(fdef->function_definition_arguments->items);
-            free(fdef->function_definition_arguments);
+            dynamic_list_free(fdef->function_definition_arguments);
             fdef->function_definition_arguments = (void*) 0;
         }
 
@@ -60,17 +43,61 @@ void holyc_cleanup(
                     ast_free((AST_T*)fdef->composition_children->items[i]);
             }
 
-            free(fdef->composition_children->items);
-            free(fdef->composition_children);
+            dynamic_list_free(fdef->composition_children);
             fdef->composition_children = (void*) 0;
         } 
 
         free(fdef);
     }
 
+    dynamic_list_free(methods);
+}
+
+/**
+ * Clean & deallocate holyc
+ */
+void holyc_cleanup(
+    holyc_lexer_T* holyc_lexer,
+    holyc_parser_T* parser,
+    runtime_T* runtime,
+    AST_T* node
+)
+{
+    ast_free(node);
+
+    // the current and previous tokens are views into the lexer's tokens.
+    if (parser)
+        holyc_parser_free(parser);
+
+    // there is no lexer nor parser when running a module.
+    if (holyc_lexer)
+        holyc_lexer_free(holyc_lexer);
+    //holyc_scope_free(runtime->scope);
+    
+    /* ==== Free definitions ==== */
+
+    free_methods(runtime->list_methods);
+    free_methods(runtime->string_methods);
+    free_methods(runtime->deque_methods);
+    free_methods(runtime->map_methods);
+    free_methods(runtime->set_methods);
+    free_methods(runtime->bitset_methods);
+    free_methods(runtime->heap_methods);
+    free_methods(runtime->builder_methods);
+    free_methods(runtime->line_reader_methods);
+    free_methods(runtime->writer_methods);
+
     /* ==== Free runtime ==== */
 
-    free(runtime->list_methods->items);
-    free(runtime->list_methods);
+    holyc_include_cache_free(runtime->include_cache);
+
+    if (runtime->stdout_buffer)
+        holyc_string_free(runtime->stdout_buffer);
+
+    holyc_output_free(runtime->output);
+
+    holyc_line_reader_free((holyc_line_reader_T*) runtime->stdin_reader->object_value);
+    ast_free(runtime->stdin_reader);
+
     free(runtime);
 }
@@ -0,0 +1,174 @@
+#include "include/holyc_deque.h"
+#include <string.h>
+#include <stdio.h>
+
+#define HOLYC_DEQUE_MIN_CAPACITY 8
+
+
+static size_t round_up_pow2(size_t n)
+{
+    size_t capacity = HOLYC_DEQUE_MIN_CAPACITY;
+
+    while (capacity < n)
+        capacity *= 2;
+
+    return capacity;
+}
+
+/**
+ * Moves the items into a buffer of `capacity` items, starting at index 0.
+ */
+static void holyc_deque_resize(holyc_deque_T* deque, size_t capacity)
+{
+    void** items = malloc(capacity * sizeof(void*));
+
+    if (items == (void*)0)
+    {
+        printf("Error: Out of memory\n");
+        exit(1);
+    }
+
+    // the items wrap around at most once, so they are copied in two runs.
+    size_t first = deque->capacity - deque->head;
+
+    if (first > deque->size)
+        first = deque->size;
+
+    if (first)
+        memcpy(items, &deque->items[deque->head], first * sizeof(void*));
+
+    if (deque->size > first)
+        memcpy(&items[first], deque->items, (deque->size - first) * sizeof(void*));
+
+    free(deque->items);
+    deque->items = items;
+    deque->head = 0;
+    deque->capacity = capacity;
+}
+
+/**
+ * Creates an empty deque with room for at least `capacity` items.
+ *
+ * @param size_t capacity
+ *
+ * @return holyc_deque_T*
+ */
+holyc_deque_T* init_holyc_deque(size_t capacity)
+{
+    holyc_deque_T* deque = calloc(1, sizeof(struct holyc_DEQUE_STRUCT));
+    deque->capacity = round_up_pow2(capacity);
+    deque->items = calloc(deque->capacity, sizeof(void*));
+    deque->head = 0;
+    deque->size = 0;
+
+    return deque;
+}
+
+/**
+ * @param holyc_deque_T* deque
+ * @param void* item
+ */
+void holyc_deque_push_back(holyc_deque_T* deque, void* item)
+{
+    if (deque->size == deque->capacity)
+        holyc_deque_resize(deque, deque->capacity * 2);
+
+    deque->items[(deque->head + deque->size) & (deque->capacity - 1)] = item;
+    deque->size += 1;
+}
+
+/**
+ * @param holyc_deque_T* deque
+ * @param void* item
+ */
+void holyc_deque_push_front(holyc_deque_T* deque, void* item)
+{
+    if (deque->size == deque->capacity)
+        holyc_deque_resize(deque, deque->capacity * 2);
+
+    deque->head = (deque->head - 1) & (deque->capacity - 1);
+    deque->items[deque->head] = item;
+    deque->size += 1;
+}
+
+/**
+ * Removes the last item, the deque must not be empty.
+ *
+ * @param holyc_deque_T* deque
+ *
+ * @return void* the removed item
+ */
+void* holyc_deque_pop_back(holyc_deque_T* deque)
+{
+    deque->size -= 1;
+
+    return deque->items[(deque->head + deque->size) & (deque->capacity - 1)];
+}
+
+/**
+ * Removes the first item, the deque must not be empty.
+ *
+ * @param holyc_deque_T* deque
+ *
+ * @return void* the removed item
+ */
+void* holyc_deque_pop_front(holyc_deque_T* deque)
+{
+    void* item = deque->items[deque->head];
+
+    deque->head = (deque->head + 1) & (deque->capacity - 1);
+    deque->size -= 1;
+
+    return item;
+}
+
+/**
+ * Returns the item at `index` counted from the front, the index must be in
+ * range.
+ *
+ * @param holyc_deque_T* deque
+ * @param size_t index
+ *
+ * @return void*
+ */
+void* holyc_deque_get(holyc_deque_T* deque, size_t index)
+{
+    return deque->items[(deque->head + index) & (deque->capacity - 1)];
+}
+
+/**
+ * Removes all items, keeping the buffer.
+ *
+ * @param holyc_deque_T* deque
+ */
+void holyc_deque_clear(holyc_deque_T* deque)
+{
+    deque->head = 0;
+    deque->size = 0;
+}
+
+/**
+ * @param holyc_deque_T* deque
+ *
+ * @return holyc_deque_T* a copy of `deque`, the items themselves are shared
+ */
+holyc_deque_T* holyc_deque_copy(holyc_deque_T* deque)
+{
+    holyc_deque_T* copy = init_holyc_deque(deque->size);
+
+    for (size_t i = 0; i < deque->size; i++)
+        holyc_deque_push_back(copy, holyc_deque_get(deque, i));
+
+    return copy;
+}
+
+/**
+ * Deallocates a deque, not its items.
+ *
+ * @param holyc_deque_T* deque
+ */
+void holyc_deque_free(holyc_deque_T* deque)
+{
+    free(deque->items);
+    free(deque);
+}
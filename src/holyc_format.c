@@ -0,0 +1,417 @@
+#include "include/holyc_format.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+
+static const char digit_pairs[201] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+
+/* ==== integers ==== */
+
+static size_t digit_count_u32(uint32_t value)
+{
+    size_t count = 1;
+
+    while (value >= 10000)
+    {
+        value /= 10000;
+        count += 4;
+    }
+
+    return count + (value >= 10) + (value >= 100) + (value >= 1000);
+}
+
+static size_t digit_count_u64(uint64_t value)
+{
+    size_t count = 0;
+
+    while (value > UINT32_MAX)
+    {
+        value /= 10000;
+        count += 4;
+    }
+
+    return count + digit_count_u32((uint32_t) value);
+}
+
+/**
+ * Writes the digits of `value` so that they end right before `end`, two
+ * at a time.
+ */
+static void write_digits_u32(uint32_t value, char* end)
+{
+    while (value >= 100)
+    {
+        uint32_t pair = value % 100;
+        value /= 100;
+        end -= 2;
+        memcpy(end, &digit_pairs[pair * 2], 2);
+    }
+
+    if (value >= 10)
+    {
+        end -= 2;
+        memcpy(end, &digit_pairs[value * 2], 2);
+    }
+    else
+    {
+        end[-1] = (char) ('0' + value);
+    }
+}
+
+static void write_digits_u64(uint64_t value, char* end)
+{
+    // 64 bit divisions are slower, so only until the rest fits in 32 bits.
+    while (value > UINT32_MAX)
+    {
+        uint64_t pair = value % 100;
+        value /= 100;
+        end -= 2;
+        memcpy(end, &digit_pairs[pair * 2], 2);
+    }
+
+    write_digits_u32((uint32_t) value, end);
+}
+
+/**
+ * @param uint32_t value
+ * @param char* buffer
+ *
+ * @return size_t
+ */
+size_t holyc_format_u32(uint32_t value, char* buffer)
+{
+    size_t length = digit_count_u32(value);
+    write_digits_u32(value, &buffer[length]);
+    buffer[length] = '\0';
+
+    return length;
+}
+
+/**
+ * @param uint64_t value
+ * @param char* buffer
+ *
+ * @return size_t
+ */
+size_t holyc_format_u64(uint64_t value, char* buffer)
+{
+    if (value <= UINT32_MAX)
+        return holyc_format_u32((uint32_t) value, buffer);
+
+    size_t length = digit_count_u64(value);
+    write_digits_u64(value, &buffer[length]);
+    buffer[length] = '\0';
+
+    return length;
+}
+
+/**
+ * @param int64_t value
+ * @param char* buffer
+ *
+ * @return size_t
+ */
+size_t holyc_format_i64(int64_t value, char* buffer)
+{
+    if (value >= 0)
+        return holyc_format_u64((uint64_t) value, buffer);
+
+    buffer[0] = '-';
+
+    // negated as unsigned, so that INT64_MIN does not overflow.
+    return 1 + holyc_format_u64(0 - (uint64_t) value, &buffer[1]);
+}
+
+
+/* ==== floats ==== */
+
+/**
+ * Formats a float the way printf("%12.6f") does, which is how floats are
+ * printed.
+ *
+ * @param float value
+ * @param char* buffer
+ *
+ * @return size_t
+ */
+size_t holyc_format_float_fixed(float value, char* buffer)
+{
+    double x = value;
+
+    if (!isfinite(x) || fabs(x) >= 1e12)
+        return (size_t) snprintf(buffer, HOLYC_FORMAT_BUFFER_SIZE, "%12.6f", x);
+
+    /**
+     * A float has 24 significant bits and 1e6 has 14, so the product is
+     * exact in a double and rint rounds it to the nearest even like
+     * printf does.
+     */
+    uint64_t scaled = (uint64_t) fabs(rint(x * 1e6));
+    char digits[HOLYC_FORMAT_BUFFER_SIZE];
+    size_t length = 0;
+
+    if (signbit(x))
+        digits[length++] = '-';
+
+    length += holyc_format_u64(scaled / 1000000, &digits[length]);
+    digits[length++] = '.';
+
+    uint32_t fraction = (uint32_t) (scaled % 1000000);
+    memset(&digits[length], '0', 6);
+    write_digits_u32(fraction, &digits[length + 6]);
+    length += 6;
+
+    size_t padding = length < 12 ? 12 - length : 0;
+    memset(buffer, ' ', padding);
+    memcpy(&buffer[padding], digits, length);
+    buffer[padding + length] = '\0';
+
+    return padding + length;
+}
+
+/**
+ * Writes `digits` * 10^`exponent` positionally, or in scientific notation
+ * when that would need more than a few zeros.
+ */
+static size_t format_decimal(unsigned int negative, uint64_t digits, int exponent, char* buffer)
+{
+    while (digits && digits % 10 == 0)
+    {
+        digits /= 10;
+        exponent += 1;
+    }
+
+    char str[24];
+    int count = (int) holyc_format_u64(digits, str);
+    int point = count + exponent;
+    size_t length = 0;
+
+    if (negative)
+        buffer[length++] = '-';
+
+    if (point > -4 && point <= 16)
+    {
+        if (point <= 0)
+        {
+            memcpy(&buffer[length], "0.", 2);
+            memset(&buffer[length + 2], '0', -point);
+            length += 2 - point;
+            memcpy(&buffer[length], str, count);
+            length += count;
+        }
+        else
+        if (point >= count)
+        {
+            memcpy(&buffer[length], str, count);
+            memset(&buffer[length + count], '0', point - count);
+            length += point;
+            memcpy(&buffer[length], ".0", 2);
+            length += 2;
+        }
+        else
+        {
+            memcpy(&buffer[length], str, point);
+            buffer[length + point] = '.';
+            memcpy(&buffer[length + point + 1], &str[point], count - point);
+            length += count + 1;
+        }
+    }
+    else
+    {
+        buffer[length++] = str[0];
+
+        if (count > 1)
+        {
+            buffer[length++] = '.';
+            memcpy(&buffer[length], &str[1], count - 1);
+            length += count - 1;
+        }
+
+        int e = point - 1;
+        buffer[length++] = 'e';
+        buffer[length++] = e < 0 ? '-' : '+';
+        e = e < 0 ? -e : e;
+
+        if (e < 10)
+            buffer[length++] = '0';
+
+        length += holyc_format_u32((uint32_t) e, &buffer[length]);
+    }
+
+    buffer[length] = '\0';
+
+    return length;
+}
+
+#ifdef __SIZEOF_INT128__
+typedef unsigned __int128 u128;
+
+/**
+ * Finds the decimal with the fewest digits that still rounds to the float
+ * m * 2^e, with exact 128 bit integers. Everything is counted in units of
+ * 10^-(s+1) / 4 where s = max(0, -e), so that the float, the bounds of the
+ * values that round to it and the candidate powers of ten are integers.
+ * Returns 0 if `e` is out of the range where that fits in 128 bits.
+ */
+static unsigned int shortest_exact(uint32_t m, int e, unsigned int boundary, uint64_t* digits, int* exponent)
+{
+    if (e < -40 || e > 90)
+        return 0;
+
+    int s = e < 0 ? -e : 0;
+    u128 center, high;
+
+    if (e < 0)
+    {
+        u128 p5 = 1;
+
+        for (int i = 0; i < s; i++)
+            p5 *= 5;
+
+        center = (u128) 40 * m * p5;
+        high = (u128) 20 * p5;
+    }
+    else
+    {
+        center = ((u128) 40 * m) << e;
+        high = ((u128) 20) << e;
+    }
+
+    // the gap to the next smaller float is half as large at a power of two.
+    u128 low = boundary ? high / 2 : high;
+    u128 lo = center - low;
+    u128 hi = center + high;
+    unsigned int inclusive = (m & 1) == 0;
+
+    u128 unit = 4;
+    int q = 0;
+
+    while (unit * 10 <= hi)
+    {
+        unit *= 10;
+        q += 1;
+    }
+
+    for (;; unit /= 10, q -= 1)
+    {
+        u128 below = center / unit * unit;
+        u128 above = below == center ? below : below + unit;
+        unsigned int below_ok = inclusive ? below >= lo : below > lo;
+        unsigned int above_ok = inclusive ? above <= hi : above < hi;
+
+        if (!below_ok && !above_ok)
+            continue;
+
+        u128 chosen;
+
+        if (below_ok && above_ok)
+        {
+            u128 below_distance = center - below;
+            u128 above_distance = above - center;
+
+            if (below_distance != above_distance)
+                chosen = below_distance < above_distance ? below : above;
+            else
+                chosen = (below / unit) % 2 == 0 ? below : above;
+        }
+        else
+        {
+            chosen = below_ok ? below : above;
+        }
+
+        *digits = (uint64_t) (chosen / unit);
+        *exponent = q - s - 1;
+
+        return 1;
+    }
+}
+#endif
+
+/**
+ * Finds the shortest decimal by trying more and more digits until it
+ * parses back to `value`.
+ */
+static void shortest_slow(float value, uint64_t* digits, int* exponent)
+{
+    char str[HOLYC_FORMAT_BUFFER_SIZE];
+    int precision = 1;
+
+    for (; precision < 9; precision++)
+    {
+        snprintf(str, sizeof(str), "%.*e", precision - 1, fabs(value));
+
+        if (strtof(str, (void*)0) == fabsf(value))
+            break;
+    }
+
+    snprintf(str, sizeof(str), "%.*e", precision - 1, fabs(value));
+
+    uint64_t d = 0;
+    char* c = str;
+
+    for (; *c != 'e'; c++)
+    {
+        if (*c != '.')
+            d = d * 10 + (uint64_t) (*c - '0');
+    }
+
+    *digits = d;
+    *exponent = atoi(c + 1) - (precision - 1);
+}
+
+/**
+ * Formats a float with the fewest digits that parse back to the same
+ * float, always with a decimal point or an exponent so that it does not
+ * read as an int.
+ *
+ * @param float value
+ * @param char* buffer
+ *
+ * @return size_t
+ */
+size_t holyc_format_float_shortest(float value, char* buffer)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    unsigned int negative = bits >> 31;
+    uint32_t biased = (bits >> 23) & 0xff;
+    uint32_t fraction = bits & 0x7fffff;
+
+    if (biased == 0xff)
+    {
+        const char* str = fraction ? "nan" : negative ? "-inf" : "inf";
+        strcpy(buffer, str);
+
+        return strlen(str);
+    }
+
+    if (biased == 0 && fraction == 0)
+    {
+        strcpy(buffer, negative ? "-0.0" : "0.0");
+
+        return negative ? 4 : 3;
+    }
+
+    uint64_t digits;
+    int exponent;
+
+#ifdef __SIZEOF_INT128__
+    uint32_t m = biased ? fraction | (1u << 23) : fraction;
+    int e = biased ? (int) biased - 150 : -149;
+
+    if (!shortest_exact(m, e, fraction == 0 && biased > 1, &digits, &exponent))
+        shortest_slow(value, &digits, &exponent);
+#else
+    shortest_slow(value, &digits, &exponent);
+#endif
+
+    return format_decimal(negative, digits, exponent, buffer);
+}
@@ -0,0 +1,314 @@
+#include "include/holyc_heap.h"
+#include "include/holyc_sort.h"
+#include <string.h>
+#include <stdio.h>
+
+
+/* ==== unboxed keys ==== */
+
+#define SIFT_KEYS(suffix, type) \
+static void sift_up_##suffix(type* keys, size_t i) \
+{ \
+    type key = keys[i]; \
+    while (i > 0) \
+    { \
+        size_t parent = (i - 1) / 2; \
+        if (!(key < keys[parent])) \
+            break; \
+        keys[i] = keys[parent]; \
+        i = parent; \
+    } \
+    keys[i] = key; \
+} \
+\
+static void sift_down_##suffix(type* keys, size_t size, size_t i) \
+{ \
+    type key = keys[i]; \
+    size_t child; \
+    while ((child = 2 * i + 1) < size) \
+    { \
+        if (child + 1 < size && keys[child + 1] < keys[child]) \
+            child += 1; \
+        if (!(keys[child] < key)) \
+            break; \
+        keys[i] = keys[child]; \
+        i = child; \
+    } \
+    keys[i] = key; \
+}
+
+SIFT_KEYS(i64, int64_t)
+SIFT_KEYS(f64, double)
+
+static void keys_sift_up(holyc_typed_list_T* keys, size_t i)
+{
+    if (keys->type == HOLYC_TYPED_LIST_FLOAT)
+        sift_up_f64(holyc_typed_list_mutable_data(keys), i);
+    else
+        sift_up_i64(holyc_typed_list_mutable_data(keys), i);
+}
+
+static void keys_sift_down(holyc_typed_list_T* keys, size_t i)
+{
+    if (keys->type == HOLYC_TYPED_LIST_FLOAT)
+        sift_down_f64(holyc_typed_list_mutable_data(keys), keys->size, i);
+    else
+        sift_down_i64(holyc_typed_list_mutable_data(keys), keys->size, i);
+}
+
+
+/* ==== boxed nodes ==== */
+
+static unsigned int node_less(holyc_heap_T* heap, AST_T* a, AST_T* b)
+{
+    return heap->less ? heap->less(heap->context, a, b) : holyc_sort_less_by_value((void*)0, a, b);
+}
+
+static void nodes_sift_up(holyc_heap_T* heap, size_t i)
+{
+    AST_T** nodes = (AST_T**) heap->nodes->items;
+    AST_T* node = nodes[i];
+
+    while (i > 0)
+    {
+        size_t parent = (i - 1) / 2;
+
+        if (!node_less(heap, node, nodes[parent]))
+            break;
+
+        nodes[i] = nodes[parent];
+        i = parent;
+    }
+
+    nodes[i] = node;
+}
+
+static void nodes_sift_down(holyc_heap_T* heap, size_t i)
+{
+    AST_T** nodes = (AST_T**) heap->nodes->items;
+    size_t size = heap->nodes->size;
+    AST_T* node = nodes[i];
+    size_t child;
+
+    while ((child = 2 * i + 1) < size)
+    {
+        if (child + 1 < size && node_less(heap, nodes[child + 1], nodes[child]))
+            child += 1;
+
+        if (!node_less(heap, nodes[child], node))
+            break;
+
+        nodes[i] = nodes[child];
+        i = child;
+    }
+
+    nodes[i] = node;
+}
+
+/**
+ * Moves the unboxed keys into boxed nodes, the order of a heap of keys is
+ * also a valid order of the same heap of nodes.
+ */
+static void box_keys(holyc_heap_T* heap)
+{
+    holyc_typed_list_T* keys = heap->keys;
+    heap->keys = (void*)0;
+
+    if (keys == (void*)0)
+        return;
+
+    dynamic_list_reserve(heap->nodes, keys->size);
+
+    for (size_t i = 0; i < keys->size; i++)
+        dynamic_list_append(heap->nodes, holyc_typed_list_box(keys, i));
+
+    holyc_typed_list_free(keys);
+}
+
+
+/**
+ * Creates an empty heap, `less` may be NULL to order the items by value.
+ *
+ * @param holyc_heap_less_T less
+ * @param void* context passed to `less`
+ *
+ * @return holyc_heap_T*
+ */
+holyc_heap_T* init_holyc_heap(holyc_heap_less_T less, void* context)
+{
+    holyc_heap_T* heap = calloc(1, sizeof(struct holyc_HEAP_STRUCT));
+    heap->keys = (void*)0;
+    heap->nodes = init_dynamic_list(sizeof(struct AST_STRUCT*));
+    heap->less = less;
+    heap->context = context;
+
+    return heap;
+}
+
+/**
+ * @param holyc_heap_T* heap
+ *
+ * @return size_t
+ */
+size_t holyc_heap_size(holyc_heap_T* heap)
+{
+    return heap->keys ? heap->keys->size : heap->nodes->size;
+}
+
+/**
+ * Pushes `item` onto the heap, the heap keeps the node it is given unless
+ * the value is stored unboxed.
+ *
+ * @param holyc_heap_T* heap
+ * @param AST_T* item
+ */
+void holyc_heap_push(holyc_heap_T* heap, AST_T* item)
+{
+    // an empty heap without a comparator takes the type of its first item.
+    if (heap->less == (void*)0 && holyc_heap_size(heap) == 0 && heap->keys == (void*)0)
+    {
+        int type = holyc_typed_list_type_of(item);
+
+        if (type == HOLYC_TYPED_LIST_INT || type == HOLYC_TYPED_LIST_FLOAT)
+            heap->keys = init_holyc_typed_list(type);
+    }
+
+    if (heap->keys)
+    {
+        if (holyc_typed_list_append(heap->keys, item))
+        {
+            keys_sift_up(heap->keys, heap->keys->size - 1);
+            return;
+        }
+
+        box_keys(heap);
+    }
+
+    dynamic_list_append(heap->nodes, item);
+    nodes_sift_up(heap, heap->nodes->size - 1);
+}
+
+/**
+ * Pushes `size` items at once, building the heap bottom up in O(n) when
+ * the heap is empty.
+ *
+ * @param holyc_heap_T* heap
+ * @param AST_T** items
+ * @param size_t size
+ */
+void holyc_heap_push_many(holyc_heap_T* heap, AST_T** items, size_t size)
+{
+    if (holyc_heap_size(heap) != 0 || size == 0)
+    {
+        for (size_t i = 0; i < size; i++)
+            holyc_heap_push(heap, items[i]);
+
+        return;
+    }
+
+    // the first item decides whether the keys are unboxed.
+    holyc_heap_push(heap, items[0]);
+
+    for (size_t i = 1; i < size; i++)
+    {
+        if (heap->keys && holyc_typed_list_append(heap->keys, items[i]))
+            continue;
+
+        box_keys(heap);
+        dynamic_list_append(heap->nodes, items[i]);
+    }
+
+    for (size_t i = holyc_heap_size(heap) / 2; i-- > 0;)
+    {
+        if (heap->keys)
+            keys_sift_down(heap->keys, i);
+        else
+            nodes_sift_down(heap, i);
+    }
+}
+
+/**
+ * @param holyc_heap_T* heap
+ *
+ * @return AST_T* the item that would be popped, or NULL if the heap is empty
+ */
+AST_T* holyc_heap_peek(holyc_heap_T* heap)
+{
+    if (holyc_heap_size(heap) == 0)
+        return (void*)0;
+
+    if (heap->keys)
+        return holyc_typed_list_box(heap->keys, 0);
+
+    return (AST_T*) heap->nodes->items[0];
+}
+
+/**
+ * @param holyc_heap_T* heap
+ *
+ * @return AST_T* the popped item, or NULL if the heap is empty
+ */
+AST_T* holyc_heap_pop(holyc_heap_T* heap)
+{
+    AST_T* top = holyc_heap_peek(heap);
+
+    if (top == (void*)0)
+        return top;
+
+    if (heap->keys)
+    {
+        holyc_typed_list_T* keys = heap->keys;
+        char* data = (char*) holyc_typed_list_mutable_data(keys);
+
+        keys->size -= 1;
+
+        if (keys->size)
+        {
+            memcpy(data, &data[keys->size * keys->item_size], keys->item_size);
+            keys_sift_down(keys, 0);
+        }
+
+        return top;
+    }
+
+    heap->nodes->size -= 1;
+
+    if (heap->nodes->size)
+    {
+        heap->nodes->items[0] = heap->nodes->items[heap->nodes->size];
+        nodes_sift_down(heap, 0);
+    }
+
+    return top;
+}
+
+/**
+ * @param holyc_heap_T* heap
+ *
+ * @return holyc_heap_T* a heap with the same items and comparator
+ */
+holyc_heap_T* holyc_heap_copy(holyc_heap_T* heap)
+{
+    holyc_heap_T* copy = init_holyc_heap(heap->less, heap->context);
+
+    if (heap->keys)
+        copy->keys = holyc_typed_list_copy(heap->keys);
+
+    dynamic_list_append_many(copy->nodes, heap->nodes->items, heap->nodes->size);
+
+    return copy;
+}
+
+/**
+ * Deallocates a heap, but not its items.
+ *
+ * @param holyc_heap_T* heap
+ */
+void holyc_heap_free(holyc_heap_T* heap)
+{
+    if (heap->keys)
+        holyc_typed_list_free(heap->keys);
+
+    dynamic_list_free(heap->nodes);
+    free(heap);
+}
@@ -0,0 +1,386 @@
+#define _XOPEN_SOURCE 700
+#include "include/holyc_include_cache.h"
+#include "include/holyc_lexer.h"
+#include "include/holyc_parser.h"
+#include "include/holyc_module.h"
+#include "include/holyc_parse_error.h"
+#include "include/string_utils.h"
+#include "include/io.h"
+#include <sys/stat.h>
+#include <limits.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdio.h>
+
+
+/**
+ * Creates an empty include cache.
+ *
+ * @return holyc_include_cache_T*
+ */
+holyc_include_cache_T* init_holyc_include_cache()
+{
+    holyc_include_cache_T* cache = calloc(1, sizeof(struct holyc_INCLUDE_CACHE_STRUCT));
+    map_init(&cache->entries);
+    cache->hits = 0;
+    cache->misses = 0;
+    cache->pool = (void*)0;
+
+    pthread_mutex_init(&cache->lock, (void*)0);
+    pthread_cond_init(&cache->parsed, (void*)0);
+
+    return cache;
+}
+
+static AST_T* parse_contents(holyc_include_cache_T* cache, char* contents)
+{
+    holyc_lexer_T* lexer = init_holyc_lexer(contents);
+    holyc_parser_T* parser = init_holyc_parser(lexer);
+    AST_T* node = holyc_parser_parse(parser, (void*) 0);
+
+    if (cache)
+        holyc_include_cache_prefetch(cache, parser->include_paths);
+
+    holyc_parser_free(parser);
+    holyc_lexer_free(lexer);
+
+    return node;
+}
+
+static AST_T* parse_path(holyc_include_cache_T* cache, const char* path, char* contents)
+{
+    if (holyc_module_is_module(path))
+    {
+        free(contents);
+        return holyc_module_load(path);
+    }
+
+    return parse_contents(cache, contents);
+}
+
+/**
+ * Stores a parsed node on an entry and wakes up everyone waiting for it.
+ * `size` is the number of chars that were read and hashed.
+ * Must be called with the cache lock held.
+ */
+static void entry_parsed(holyc_include_cache_T* cache, holyc_include_cache_entry_T* entry, AST_T* node, struct stat* st, off_t size, uint32_t hash)
+{
+    entry->node = node;
+    entry->mtime_sec = st->st_mtim.tv_sec;
+    entry->mtime_nsec = st->st_mtim.tv_nsec;
+    entry->size = size;
+    entry->hash = hash;
+    entry->pending = 0;
+
+    pthread_cond_broadcast(&cache->parsed);
+}
+
+/**
+ * Returns the node of an entry that is done, reporting the parse error of
+ * a prefetched file now that it is included.
+ */
+static AST_T* entry_node(holyc_include_cache_entry_T* entry)
+{
+    if (entry->error)
+    {
+        printf("%s", entry->error);
+        exit(1);
+    }
+
+    return entry->node;
+}
+
+/**
+ * Parses a file that may never be included, so a parse error is stored on
+ * the entry instead of being reported. The lexer and parser of a failed
+ * parse are not freed.
+ */
+static void prefetch_job(void* arg)
+{
+    holyc_include_cache_entry_T* entry = (holyc_include_cache_entry_T*) arg;
+    holyc_include_cache_T* cache = entry->cache;
+    struct stat st;
+
+    AST_T* node = (void*)0;
+    char* error = (void*)0;
+    off_t size = -1;
+    uint32_t hash = 0;
+
+    if (stat(entry->path, &st) == 0 && access(entry->path, R_OK) == 0)
+    {
+        size_t length;
+        char* contents = holyc_read_file_length(entry->path, &length);
+        size = (off_t) length;
+        hash = holyc_fnv1a(HOLYC_FNV1A_INIT, contents, length);
+
+        holyc_parse_error_catcher_T catcher;
+
+        if (setjmp(catcher.jump) == 0)
+        {
+            holyc_parse_error_catch(&catcher);
+            node = parse_path(cache, entry->path, contents);
+        }
+        else
+        {
+            node = (void*)0;
+            error = holyc_init_str(catcher.message);
+        }
+
+        holyc_parse_error_catch((void*)0);
+    }
+    else
+    {
+        // the file vanished or cannot be read, let holyc_include_cache_get report it.
+        memset(&st, 0, sizeof(st));
+    }
+
+    pthread_mutex_lock(&cache->lock);
+    entry->error = error;
+    entry_parsed(cache, entry, node, &st, size, hash);
+    pthread_mutex_unlock(&cache->lock);
+}
+
+/**
+ * Parses a script, or loads it if it is a compiled module.
+ *
+ * @param const char* filename
+ *
+ * @return AST_T*
+ */
+AST_T* holyc_include_cache_parse_file(const char* filename)
+{
+    return parse_path((void*)0, filename, holyc_module_is_module(filename) ? (void*)0 : holyc_read_file(filename));
+}
+
+/**
+ * Starts parsing every path that is not in the cache yet on the pool of
+ * the cache, files that do not exist are skipped.
+ * Includes found in those files are prefetched as well.
+ *
+ * @param holyc_include_cache_T* cache
+ * @param dynamic_list_T* paths
+ */
+void holyc_include_cache_prefetch(holyc_include_cache_T* cache, dynamic_list_T* paths)
+{
+    char path[PATH_MAX];
+
+    for (size_t i = 0; i < paths->size; i++)
+    {
+        if (realpath((char*) paths->items[i], path) == (void*)0)
+            continue;
+
+        pthread_mutex_lock(&cache->lock);
+
+        if (map_get(&cache->entries, path))
+        {
+            pthread_mutex_unlock(&cache->lock);
+            continue;
+        }
+
+        holyc_include_cache_entry_T* entry = calloc(1, sizeof(struct holyc_INCLUDE_CACHE_ENTRY_STRUCT));
+        entry->path = holyc_init_str(path);
+        entry->cache = cache;
+        entry->pending = 1;
+        map_set(&cache->entries, path, entry);
+
+        if (cache->pool == (void*)0)
+            cache->pool = init_holyc_thread_pool(0);
+
+        pthread_mutex_unlock(&cache->lock);
+
+        holyc_thread_pool_submit(cache->pool, prefetch_job, entry);
+    }
+}
+
+/**
+ * Returns the parsed compound of `filename`, parsing it only if it is not
+ * cached yet or if the file changed since it was cached.
+ * A file is considered unchanged if its mtime and size are the same, or
+ * if only the mtime changed but the contents hash the same.
+ * If the file is still being parsed by a worker, this waits for it.
+ *
+ * @param holyc_include_cache_T* cache
+ * @param const char* filename
+ *
+ * @return AST_T*
+ */
+AST_T* holyc_include_cache_get(holyc_include_cache_T* cache, const char* filename)
+{
+    char path[PATH_MAX];
+    struct stat st;
+
+    // let holyc_read_file report files that do not exist.
+    if (realpath(filename, path) == (void*)0 || stat(path, &st) != 0)
+        return holyc_include_cache_parse_file(filename);
+
+    pthread_mutex_lock(&cache->lock);
+
+    holyc_include_cache_entry_T** found = map_get(&cache->entries, path);
+    holyc_include_cache_entry_T* entry = found ? *found : (void*)0;
+
+    while (entry && entry->pending)
+        pthread_cond_wait(&cache->parsed, &cache->lock);
+
+    if (entry && entry->size == st.st_size &&
+        entry->mtime_sec == st.st_mtim.tv_sec && entry->mtime_nsec == st.st_mtim.tv_nsec)
+    {
+        cache->hits += 1;
+        pthread_mutex_unlock(&cache->lock);
+
+        return entry_node(entry);
+    }
+
+    pthread_mutex_unlock(&cache->lock);
+
+    size_t length;
+    char* contents = holyc_read_file_length(path, &length);
+    uint32_t hash = holyc_fnv1a(HOLYC_FNV1A_INIT, contents, length);
+
+    pthread_mutex_lock(&cache->lock);
+
+    if (entry && entry->size == (off_t) length && entry->hash == hash)
+    {
+        entry->mtime_sec = st.st_mtim.tv_sec;
+        entry->mtime_nsec = st.st_mtim.tv_nsec;
+
+        cache->hits += 1;
+        pthread_mutex_unlock(&cache->lock);
+
+        free(contents);
+
+        return entry_node(entry);
+    }
+
+    cache->misses += 1;
+
+    if (entry == (void*)0)
+    {
+        entry = calloc(1, sizeof(struct holyc_INCLUDE_CACHE_ENTRY_STRUCT));
+        entry->path = holyc_init_str(path);
+        entry->cache = cache;
+        map_set(&cache->entries, path, entry);
+    }
+
+    if (entry->error)
+    {
+        free(entry->error);
+        entry->error = (void*)0;
+    }
+
+    entry->pending = 1;
+    pthread_mutex_unlock(&cache->lock);
+
+    // a stale node is not freed, its definitions may still live in a scope.
+    AST_T* node = parse_path(cache, path, contents);
+
+    pthread_mutex_lock(&cache->lock);
+    entry_parsed(cache, entry, node, &st, (off_t) length, hash);
+    pthread_mutex_unlock(&cache->lock);
+
+    return node;
+}
+
+/**
+ * Parses every file listed in `manifest` into the cache, in parallel.
+ * The manifest has one path per line, relative to the working directory
+ * just like include(), empty lines and lines starting with `#` are skipped.
+ *
+ * @param holyc_include_cache_T* cache
+ * @param const char* manifest
+ *
+ * @return unsigned int the number of files listed
+ */
+unsigned int holyc_include_cache_prewarm(holyc_include_cache_T* cache, const char* manifest)
+{
+    FILE* f = fopen(manifest, "r");
+
+    if (f == (void*)0)
+    {
+        printf("Error: Could not open manifest %s\n", manifest);
+        exit(1);
+    }
+
+    char line[PATH_MAX + 2];
+    dynamic_list_T* paths = init_dynamic_list(sizeof(char*));
+
+    while (fgets(line, sizeof(line), f))
+    {
+        size_t length = strlen(line);
+
+        while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r' || line[length - 1] == ' '))
+            line[--length] = '\0';
+
+        if (length == 0 || line[0] == '#')
+            continue;
+
+        dynamic_list_append(paths, holyc_init_str(line));
+    }
+
+    fclose(f);
+
+    holyc_include_cache_prefetch(cache, paths);
+
+    unsigned int n = paths->size;
+
+    for (size_t i = 0; i < paths->size; i++)
+    {
+        holyc_include_cache_get(cache, (char*) paths->items[i]);
+        free(paths->items[i]);
+    }
+
+    dynamic_list_free(paths);
+
+    return n;
+}
+
+/**
+ * Waits for the files that are being prefetched, so that a process forked
+ * afterwards gets a cache without pending entries or held locks.
+ *
+ * @param holyc_include_cache_T* cache
+ */
+void holyc_include_cache_prepare_fork(holyc_include_cache_T* cache)
+{
+    if (cache->pool)
+        holyc_thread_pool_wait(cache->pool);
+}
+
+/**
+ * Called in a forked process, which has none of the threads of the pool.
+ * A pool of its own is started once it prefetches.
+ *
+ * @param holyc_include_cache_T* cache
+ */
+void holyc_include_cache_forked(holyc_include_cache_T* cache)
+{
+    cache->pool = (void*)0;
+}
+
+/**
+ * Deallocates the cache, the cached nodes are left alone since they may
+ * still be referenced from the runtime.
+ *
+ * @param holyc_include_cache_T* cache
+ */
+void holyc_include_cache_free(holyc_include_cache_T* cache)
+{
+    // finishes the prefetches that were never waited for.
+    if (cache->pool)
+        holyc_thread_pool_free(cache->pool);
+
+    const char* key;
+    map_iter_t iter = map_iter(&cache->entries);
+
+    while ((key = map_next(&cache->entries, &iter)))
+    {
+        holyc_include_cache_entry_T* entry = *map_get(&cache->entries, key);
+        free(entry->path);
+        free(entry->error);
+        free(entry);
+    }
+
+    map_deinit(&cache->entries);
+    pthread_mutex_destroy(&cache->lock);
+    pthread_cond_destroy(&cache->parsed);
+    free(cache);
+}
@@ -0,0 +1,323 @@
+#include "include/holyc_kernels.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+/* ==== vector helpers ==== */
+
+#if defined(__AVX__)
+/* doubles per vector */
+#define F64_WIDTH 4
+typedef __m256d f64_vec;
+#define f64_load(p) _mm256_loadu_pd(p)
+#define f64_store(p, v) _mm256_storeu_pd((p), (v))
+#define f64_set1(a) _mm256_set1_pd(a)
+#define f64_zero() _mm256_setzero_pd()
+#define f64_add(a, b) _mm256_add_pd((a), (b))
+#define f64_mul(a, b) _mm256_mul_pd((a), (b))
+#define f64_min(a, b) _mm256_min_pd((a), (b))
+#define f64_max(a, b) _mm256_max_pd((a), (b))
+#elif defined(__SSE2__)
+#define F64_WIDTH 2
+typedef __m128d f64_vec;
+#define f64_load(p) _mm_loadu_pd(p)
+#define f64_store(p, v) _mm_storeu_pd((p), (v))
+#define f64_set1(a) _mm_set1_pd(a)
+#define f64_zero() _mm_setzero_pd()
+#define f64_add(a, b) _mm_add_pd((a), (b))
+#define f64_mul(a, b) _mm_mul_pd((a), (b))
+#define f64_min(a, b) _mm_min_pd((a), (b))
+#define f64_max(a, b) _mm_max_pd((a), (b))
+#endif
+
+#if defined(__AVX2__)
+#define I64_WIDTH 4
+typedef __m256i i64_vec;
+#define i64_load(p) _mm256_loadu_si256((const __m256i*)(p))
+#define i64_store(p, v) _mm256_storeu_si256((__m256i*)(p), (v))
+#define i64_zero() _mm256_setzero_si256()
+#define i64_add(a, b) _mm256_add_epi64((a), (b))
+#elif defined(__SSE2__)
+#define I64_WIDTH 2
+typedef __m128i i64_vec;
+#define i64_load(p) _mm_loadu_si128((const __m128i*)(p))
+#define i64_store(p, v) _mm_storeu_si128((__m128i*)(p), (v))
+#define i64_zero() _mm_setzero_si128()
+#define i64_add(a, b) _mm_add_epi64((a), (b))
+#endif
+
+#ifdef F64_WIDTH
+static double f64_reduce_add(f64_vec v)
+{
+    double lanes[F64_WIDTH];
+    f64_store(lanes, v);
+
+    double r = lanes[0];
+
+    for (int i = 1; i < F64_WIDTH; i++)
+        r += lanes[i];
+
+    return r;
+}
+#endif
+
+
+/* ==== reductions ==== */
+
+int64_t holyc_kernel_sum_i64(const int64_t* x, size_t n)
+{
+    size_t i = 0;
+    int64_t sum = 0;
+
+#ifdef I64_WIDTH
+    i64_vec acc = i64_zero();
+
+    for (; i + I64_WIDTH <= n; i += I64_WIDTH)
+        acc = i64_add(acc, i64_load(&x[i]));
+
+    int64_t lanes[I64_WIDTH];
+    i64_store(lanes, acc);
+
+    for (int l = 0; l < I64_WIDTH; l++)
+        sum += lanes[l];
+#endif
+
+    for (; i < n; i++)
+        sum += x[i];
+
+    return sum;
+}
+
+double holyc_kernel_sum_f64(const double* x, size_t n)
+{
+    size_t i = 0;
+    double sum = 0;
+
+#ifdef F64_WIDTH
+    // two accumulators to not wait on the latency of each add.
+    f64_vec acc0 = f64_zero();
+    f64_vec acc1 = f64_zero();
+
+    for (; i + 2 * F64_WIDTH <= n; i += 2 * F64_WIDTH)
+    {
+        acc0 = f64_add(acc0, f64_load(&x[i]));
+        acc1 = f64_add(acc1, f64_load(&x[i + F64_WIDTH]));
+    }
+
+    sum = f64_reduce_add(f64_add(acc0, acc1));
+#endif
+
+    for (; i < n; i++)
+        sum += x[i];
+
+    return sum;
+}
+
+/* min and max expect at least one item */
+
+int64_t holyc_kernel_min_i64(const int64_t* x, size_t n)
+{
+    int64_t r = x[0];
+
+    for (size_t i = 1; i < n; i++)
+        r = x[i] < r ? x[i] : r;
+
+    return r;
+}
+
+int64_t holyc_kernel_max_i64(const int64_t* x, size_t n)
+{
+    int64_t r = x[0];
+
+    for (size_t i = 1; i < n; i++)
+        r = x[i] > r ? x[i] : r;
+
+    return r;
+}
+
+double holyc_kernel_min_f64(const double* x, size_t n)
+{
+    size_t i = 0;
+    double r = x[0];
+
+#ifdef F64_WIDTH
+    if (n >= F64_WIDTH)
+    {
+        f64_vec acc = f64_load(x);
+
+        for (i = F64_WIDTH; i + F64_WIDTH <= n; i += F64_WIDTH)
+            acc = f64_min(acc, f64_load(&x[i]));
+
+        double lanes[F64_WIDTH];
+        f64_store(lanes, acc);
+
+        for (int l = 0; l < F64_WIDTH; l++)
+            r = lanes[l] < r ? lanes[l] : r;
+    }
+#endif
+
+    for (; i < n; i++)
+        r = x[i] < r ? x[i] : r;
+
+    return r;
+}
+
+double holyc_kernel_max_f64(const double* x, size_t n)
+{
+    size_t i = 0;
+    double r = x[0];
+
+#ifdef F64_WIDTH
+    if (n >= F64_WIDTH)
+    {
+        f64_vec acc = f64_load(x);
+
+        for (i = F64_WIDTH; i + F64_WIDTH <= n; i += F64_WIDTH)
+            acc = f64_max(acc, f64_load(&x[i]));
+
+        double lanes[F64_WIDTH];
+        f64_store(lanes, acc);
+
+        for (int l = 0; l < F64_WIDTH; l++)
+            r = lanes[l] > r ? lanes[l] : r;
+    }
+#endif
+
+    for (; i < n; i++)
+        r = x[i] > r ? x[i] : r;
+
+    return r;
+}
+
+int64_t holyc_kernel_dot_i64(const int64_t* x, const int64_t* y, size_t n)
+{
+    int64_t sum = 0;
+
+    for (size_t i = 0; i < n; i++)
+        sum += x[i] * y[i];
+
+    return sum;
+}
+
+double holyc_kernel_dot_f64(const double* x, const double* y, size_t n)
+{
+    size_t i = 0;
+    double sum = 0;
+
+#ifdef F64_WIDTH
+    f64_vec acc0 = f64_zero();
+    f64_vec acc1 = f64_zero();
+
+    for (; i + 2 * F64_WIDTH <= n; i += 2 * F64_WIDTH)
+    {
+        acc0 = f64_add(acc0, f64_mul(f64_load(&x[i]), f64_load(&y[i])));
+        acc1 = f64_add(acc1, f64_mul(f64_load(&x[i + F64_WIDTH]), f64_load(&y[i + F64_WIDTH])));
+    }
+
+    sum = f64_reduce_add(f64_add(acc0, acc1));
+#endif
+
+    for (; i < n; i++)
+        sum += x[i] * y[i];
+
+    return sum;
+}
+
+
+/* ==== elementwise, `out` may be one of the inputs ==== */
+
+void holyc_kernel_axpy_i64(int64_t a, const int64_t* x, int64_t* y, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        y[i] += a * x[i];
+}
+
+void holyc_kernel_axpy_f64(double a, const double* x, double* y, size_t n)
+{
+    size_t i = 0;
+
+#ifdef F64_WIDTH
+    f64_vec va = f64_set1(a);
+
+    for (; i + F64_WIDTH <= n; i += F64_WIDTH)
+        f64_store(&y[i], f64_add(f64_load(&y[i]), f64_mul(va, f64_load(&x[i]))));
+#endif
+
+    for (; i < n; i++)
+        y[i] += a * x[i];
+}
+
+void holyc_kernel_add_i64(const int64_t* x, const int64_t* y, int64_t* out, size_t n)
+{
+    size_t i = 0;
+
+#ifdef I64_WIDTH
+    for (; i + I64_WIDTH <= n; i += I64_WIDTH)
+        i64_store(&out[i], i64_add(i64_load(&x[i]), i64_load(&y[i])));
+#endif
+
+    for (; i < n; i++)
+        out[i] = x[i] + y[i];
+}
+
+void holyc_kernel_add_f64(const double* x, const double* y, double* out, size_t n)
+{
+    size_t i = 0;
+
+#ifdef F64_WIDTH
+    for (; i + F64_WIDTH <= n; i += F64_WIDTH)
+        f64_store(&out[i], f64_add(f64_load(&x[i]), f64_load(&y[i])));
+#endif
+
+    for (; i < n; i++)
+        out[i] = x[i] + y[i];
+}
+
+void holyc_kernel_mul_i64(const int64_t* x, const int64_t* y, int64_t* out, size_t n)
+{
+    // there is no packed 64 bit multiply before AVX-512.
+    for (size_t i = 0; i < n; i++)
+        out[i] = x[i] * y[i];
+}
+
+void holyc_kernel_mul_f64(const double* x, const double* y, double* out, size_t n)
+{
+    size_t i = 0;
+
+#ifdef F64_WIDTH
+    for (; i + F64_WIDTH <= n; i += F64_WIDTH)
+        f64_store(&out[i], f64_mul(f64_load(&x[i]), f64_load(&y[i])));
+#endif
+
+    for (; i < n; i++)
+        out[i] = x[i] * y[i];
+}
+
+
+/* ==== scans, every item depends on the previous one so these stay scalar ==== */
+
+void holyc_kernel_cumsum_i64(const int64_t* x, int64_t* out, size_t n)
+{
+    int64_t sum = 0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        sum += x[i];
+        out[i] = sum;
+    }
+}
+
+void holyc_kernel_cumsum_f64(const double* x, double* out, size_t n)
+{
+    double sum = 0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        sum += x[i];
+        out[i] = sum;
+    }
+}
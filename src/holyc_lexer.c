@@ -1,5 +1,6 @@
 #include "include/holyc_lexer.h"
 #include "include/string_utils.h"
+#include "include/holyc_parse_error.h"
 #include <string.h>
 #include <ctype.h>
 #include <stdio.h>
@@ -22,6 +23,8 @@ holyc_lexer_T* init_holyc_lexer(char* contents)
     holyc_lexer->line_n = 1;
     holyc_lexer->current_char = holyc_lexer->contents[holyc_lexer->char_index];
 
+    holyc_lexer->tokens = (void*)0;
+
     return holyc_lexer;
 }
 
@@ -32,10 +35,42 @@ holyc_lexer_T* init_holyc_lexer(char* contents)
  */
 void holyc_lexer_free(holyc_lexer_T* holyc_lexer)
 {
+    if (holyc_lexer->tokens)
+        holyc_token_buffer_free(holyc_lexer->tokens);
+
     free(holyc_lexer->contents);
     free(holyc_lexer);
 }
 
+/**
+ * Lexes the remaining contents in one pass and appends every token,
+ * including the final TOKEN_EOF, to the buffer.
+ * The line of a token is the line the lexer is on once it has been
+ * collected.
+ *
+ * @param holyc_lexer_T* holyc_lexer
+ * @param holyc_token_buffer_T* buffer
+ */
+void holyc_lexer_tokenize(holyc_lexer_T* holyc_lexer, holyc_token_buffer_T* buffer)
+{
+    size_t start = 0;
+    size_t length = 0;
+
+    // most tokens are a few chars long, this avoids regrowing small sources.
+    size_t remaining = holyc_lexer->contents_length - holyc_lexer->char_index;
+    holyc_token_buffer_reserve(buffer, buffer->size + remaining / 4 + 1, buffer->text_size + remaining + 1);
+
+    while (1)
+    {
+        int type = holyc_lexer_scan_token(holyc_lexer, &start, &length);
+
+        holyc_token_buffer_push(buffer, type, &holyc_lexer->contents[start], length, holyc_lexer->line_n);
+
+        if (type == TOKEN_EOF)
+            break;
+    }
+}
+
 /**
  * Get the next token from the lexer
  *
@@ -44,151 +79,72 @@ void holyc_lexer_free(holyc_lexer_T* holyc_lexer)
  * @return token_T*
  */
 token_T* holyc_lexer_get_next_token(holyc_lexer_T* holyc_lexer)
+{
+    size_t start = 0;
+    size_t length = 0;
+
+    int type = holyc_lexer_scan_token(holyc_lexer, &start, &length);
+
+    token_T* token = init_token_slice(type, &holyc_lexer->contents[start], length);
+    token->line_n = holyc_lexer->line_n;
+
+    return token;
+}
+
+/**
+ * Scans the next token, its value is the `length` chars at `start` in the
+ * contents of the lexer.
+ *
+ * @param holyc_lexer_T* holyc_lexer
+ * @param size_t* start
+ * @param size_t* length
+ *
+ * @return int the token type
+ */
+int holyc_lexer_scan_token(holyc_lexer_T* holyc_lexer, size_t* start, size_t* length)
 {
     while (holyc_lexer->current_char != '\0' && holyc_lexer->char_index < holyc_lexer->contents_length)
     {
         if (holyc_lexer->current_char == ' ' || (int) holyc_lexer->current_char == 10 || (int) holyc_lexer->current_char == 13)
             holyc_lexer_skip_whitespace(holyc_lexer);
 
+        *start = holyc_lexer->char_index;
+
         if (isdigit(holyc_lexer->current_char))
-            return holyc_lexer_collect_number(holyc_lexer);
+            return holyc_lexer_collect_number(holyc_lexer, start, length);
 
         if (isalnum(holyc_lexer->current_char))
-            return holyc_lexer_collect_id(holyc_lexer);
+            return holyc_lexer_collect_id(holyc_lexer, start, length);
 
         if (holyc_lexer->current_char == '+')
-        {
-            char* value = holyc_lexer_current_charstr(holyc_lexer);
-
-            int type = TOKEN_PLUS;
-            holyc_lexer_advance(holyc_lexer);
-
-            if (holyc_lexer->current_char == '=')  // +=
-            {
-                type = TOKEN_PLUS_EQUALS;
-                value = realloc(value, strlen(value) + 2);
-                char* strchar = holyc_lexer_current_charstr(holyc_lexer);
-                strcat(value, strchar);
-                free(strchar);
-
-                holyc_lexer_advance(holyc_lexer);
-            }
-
-            return init_token(type, value);
-        }
+            return holyc_lexer_collect_operator(holyc_lexer, start, length, TOKEN_PLUS, '=', TOKEN_PLUS_EQUALS);  // +=
 
         if (holyc_lexer->current_char == '-')
-        {
-            char* value = holyc_lexer_current_charstr(holyc_lexer);
-
-            int type = TOKEN_MINUS;
-            holyc_lexer_advance(holyc_lexer);
-
-            if (holyc_lexer->current_char == '=')  // -=
-            {
-                type = TOKEN_MINUS_EQUALS;
-                value = realloc(value, strlen(value) + 2);
-                char* strchar = holyc_lexer_current_charstr(holyc_lexer);
-                strcat(value, strchar);
-                free(strchar);
-
-                holyc_lexer_advance(holyc_lexer);
-            }
-
-            return init_token(type, value);
-        }
+            return holyc_lexer_collect_operator(holyc_lexer, start, length, TOKEN_MINUS, '=', TOKEN_MINUS_EQUALS);  // -=
 
         if (holyc_lexer->current_char == '*')
-        {
-            char* value = holyc_lexer_current_charstr(holyc_lexer);
-
-            int type = TOKEN_STAR;
-            holyc_lexer_advance(holyc_lexer);
-
-            if (holyc_lexer->current_char == '=')  // *=
-            {
-                type = TOKEN_STAR_EQUALS;
-                value = realloc(value, strlen(value) + 2);
-                char* strchar = holyc_lexer_current_charstr(holyc_lexer);
-                strcat(value, strchar);
-                free(strchar);
-
-                holyc_lexer_advance(holyc_lexer);
-            }
-
-            return init_token(type, value);
-        }
+            return holyc_lexer_collect_operator(holyc_lexer, start, length, TOKEN_STAR, '=', TOKEN_STAR_EQUALS);  // *=
 
         if (holyc_lexer->current_char == '&')
         {
-            char* value = holyc_lexer_current_charstr(holyc_lexer);
-
             holyc_lexer_advance(holyc_lexer);
 
             if (holyc_lexer->current_char == '&')  // &&
             {
-                value = realloc(value, strlen(value) + 2);
-                char* strchar = holyc_lexer_current_charstr(holyc_lexer);
-                strcat(value, strchar);
-                free(strchar);
-
                 holyc_lexer_advance(holyc_lexer);
 
-                return init_token(TOKEN_AND, value);
+                *length = 2;
+                return TOKEN_AND;
             }
+
+            *start = holyc_lexer->char_index;
         }
 
         if (holyc_lexer->current_char == '=')
-        {
-            char* value = holyc_lexer_current_charstr(holyc_lexer);
-
-            holyc_lexer_advance(holyc_lexer);
-
-            if (holyc_lexer->current_char == '=')  // ==
-            {
-                value = realloc(value, strlen(value) + 2);
-                char* strchar = holyc_lexer_current_charstr(holyc_lexer);
-                strcat(value, strchar);
-                free(strchar);
-
-                holyc_lexer_advance(holyc_lexer);
-
-                token_T* token = init_token(TOKEN_EQUALS_EQUALS, value);
-                free(value);
-                return token;
-            }
-            else
-            {
-                token_T* token = init_token(TOKEN_EQUALS, value);
-                free(value);
-                return token;
-            }
-        }
+            return holyc_lexer_collect_operator(holyc_lexer, start, length, TOKEN_EQUALS, '=', TOKEN_EQUALS_EQUALS);  // ==
 
         if (holyc_lexer->current_char == '!')
-        {
-            char* value = holyc_lexer_current_charstr(holyc_lexer);
-
-            holyc_lexer_advance(holyc_lexer);
-
-            if (holyc_lexer->current_char == '=')  // !=
-            {
-                value = realloc(value, strlen(value) + 2);
-                char* strchar = holyc_lexer_current_charstr(holyc_lexer);
-                strcat(value, strchar);
-                free(strchar);
-
-                holyc_lexer_advance(holyc_lexer);
-
-                token_T* token = init_token(TOKEN_NOT_EQUALS, value);
-                free(value);
-                return token;
-            }
-
-            token_T* token = init_token(TOKEN_NOT, value);
-            free(value);
-            return token;
-        }
+            return holyc_lexer_collect_operator(holyc_lexer, start, length, TOKEN_NOT, '=', TOKEN_NOT_EQUALS);  // !=
 
         if (holyc_lexer->current_char == '#')
         {
@@ -215,58 +171,89 @@ token_T* holyc_lexer_get_next_token(holyc_lexer_T* holyc_lexer)
                 continue;
             }
             else
-            if (holyc_lexer->current_char != '/')
             {
-                return init_token(TOKEN_DIV, "/");
+                *length = 1;
+                return TOKEN_DIV;
             }
         }
 
         switch(holyc_lexer->current_char)
         {
-            case '"': return holyc_lexer_collect_string(holyc_lexer); break;
-            case '\'': return holyc_lexer_collect_char(holyc_lexer); break;
-            case '{': return holyc_lexer_advance_with_token(holyc_lexer, TOKEN_LBRACE); break;
-            case '}': return holyc_lexer_advance_with_token(holyc_lexer, TOKEN_RBRACE); break;
-            case '[': return holyc_lexer_advance_with_token(holyc_lexer, TOKEN_LBRACKET); break;
-            case ']': return holyc_lexer_advance_with_token(holyc_lexer, TOKEN_RBRACKET); break;
-            case '(': return holyc_lexer_advance_with_token(holyc_lexer, TOKEN_LPAREN); break;
-            case ')': return holyc_lexer_advance_with_token(holyc_lexer, TOKEN_RPAREN); break;
-            case ';': return holyc_lexer_advance_with_token(holyc_lexer, TOKEN_SEMI); break;
-            case ',': return holyc_lexer_advance_with_token(holyc_lexer, TOKEN_COMMA); break;
-            case '%': return holyc_lexer_advance_with_token(holyc_lexer, TOKEN_PERCENTAGE); break;
-            case '.': return holyc_lexer_advance_with_token(holyc_lexer, TOKEN_DOT); break;
-            case '<': return holyc_lexer_advance_with_token(holyc_lexer, TOKEN_LESS_THAN); break;
-            case '>': return holyc_lexer_advance_with_token(holyc_lexer, TOKEN_LARGER_THAN); break;
-            case '@': return holyc_lexer_advance_with_token(holyc_lexer, TOKEN_ANON_ID); break;
-            case '?': return holyc_lexer_advance_with_token(holyc_lexer, TOKEN_QUESTION); break;
-            case ':': return holyc_lexer_advance_with_token(holyc_lexer, TOKEN_COLON); break;
-            case '\0': return init_token(TOKEN_EOF, "\0"); break;
-            default: printf("[Line %d] Unexpected %c\n", holyc_lexer->line_n, holyc_lexer->current_char); exit(1); break;
+            case '"': return holyc_lexer_collect_string(holyc_lexer, start, length); break;
+            case '\'': return holyc_lexer_collect_char(holyc_lexer, start, length); break;
+            case '{': return holyc_lexer_advance_with_token(holyc_lexer, length, TOKEN_LBRACE); break;
+            case '}': return holyc_lexer_advance_with_token(holyc_lexer, length, TOKEN_RBRACE); break;
+            case '[': return holyc_lexer_advance_with_token(holyc_lexer, length, TOKEN_LBRACKET); break;
+            case ']': return holyc_lexer_advance_with_token(holyc_lexer, length, TOKEN_RBRACKET); break;
+            case '(': return holyc_lexer_advance_with_token(holyc_lexer, length, TOKEN_LPAREN); break;
+            case ')': return holyc_lexer_advance_with_token(holyc_lexer, length, TOKEN_RPAREN); break;
+            case ';': return holyc_lexer_advance_with_token(holyc_lexer, length, TOKEN_SEMI); break;
+            case ',': return holyc_lexer_advance_with_token(holyc_lexer, length, TOKEN_COMMA); break;
+            case '%': return holyc_lexer_advance_with_token(holyc_lexer, length, TOKEN_PERCENTAGE); break;
+            case '.': return holyc_lexer_advance_with_token(holyc_lexer, length, TOKEN_DOT); break;
+            case '<': return holyc_lexer_advance_with_token(holyc_lexer, length, TOKEN_LESS_THAN); break;
+            case '>': return holyc_lexer_advance_with_token(holyc_lexer, length, TOKEN_LARGER_THAN); break;
+            case '@': return holyc_lexer_advance_with_token(holyc_lexer, length, TOKEN_ANON_ID); break;
+            case '?': return holyc_lexer_advance_with_token(holyc_lexer, length, TOKEN_QUESTION); break;
+            case ':': return holyc_lexer_advance_with_token(holyc_lexer, length, TOKEN_COLON); break;
+            case '\0': *length = 0; return TOKEN_EOF; break;
+            default: holyc_parse_error("[Line %d] Unexpected %c\n", holyc_lexer->line_n, holyc_lexer->current_char); break;
         }
     }
 
-    return init_token(TOKEN_EOF, "\0");
+    *start = holyc_lexer->char_index;
+    *length = 0;
+
+    return TOKEN_EOF;
 }
 
 /**
- * Advances and also returns a token
+ * Advances and also returns a token type, the token is one char long.
  *
  * @param holyc_lexer_T* holyc_lexer
+ * @param size_t* length
  * @param int type
  *
- * @return token_T*
+ * @return int
  */
-token_T* holyc_lexer_advance_with_token(holyc_lexer_T* holyc_lexer, int type)
+int holyc_lexer_advance_with_token(holyc_lexer_T* holyc_lexer, size_t* length, int type)
 {
-    char* value = holyc_lexer_current_charstr(holyc_lexer);
     holyc_lexer_advance(holyc_lexer);
-    token_T* token = init_token(type, value);
-    free(value);
+    *length = 1;
 
     // ensures that the lexer state is correct if exited through this function.
     holyc_lexer_skip_whitespace(holyc_lexer);
 
-    return token;
+    return type;
+}
+
+/**
+ * Collects a one char operator, or a two char one if the operator is
+ * followed by `next`.
+ *
+ * @param holyc_lexer_T* holyc_lexer
+ * @param size_t* start
+ * @param size_t* length
+ * @param int type
+ * @param char next
+ * @param int next_type
+ *
+ * @return int
+ */
+int holyc_lexer_collect_operator(holyc_lexer_T* holyc_lexer, size_t* start, size_t* length, int type, char next, int next_type)
+{
+    holyc_lexer_advance(holyc_lexer);
+    *length = 1;
+
+    if (holyc_lexer->current_char == next)
+    {
+        holyc_lexer_advance(holyc_lexer);
+        *length = 2;
+
+        return next_type;
+    }
+
+    return type;
 }
 
 /**
@@ -282,7 +269,10 @@ void holyc_lexer_advance(holyc_lexer_T* holyc_lexer)
     if (holyc_lexer->current_char != '\0' && holyc_lexer->char_index < holyc_lexer->contents_length)
     {
         holyc_lexer->char_index += 1;
-        holyc_lexer->current_char = holyc_lexer->contents[holyc_lexer->char_index];
+
+        // contents_length may end before the buffer does, see holyc_parallel_lexer.c
+        holyc_lexer->current_char = holyc_lexer->char_index < holyc_lexer->contents_length ?
+            holyc_lexer->contents[holyc_lexer->char_index] : '\0';
     }
     else
     {
@@ -300,8 +290,7 @@ void holyc_lexer_expect_char(holyc_lexer_T* holyc_lexer, char c)
 {
     if (holyc_lexer->current_char != c)
     {
-        printf("Error: [Line %d] Lexer expected the current char to be `%c`, but it was `%c`.", c, holyc_lexer->current_char, holyc_lexer->line_n);
-        exit(1);
+        holyc_parse_error("Error: [Line %d] Lexer expected the current char to be `%c`, but it was `%c`.", c, holyc_lexer->current_char, holyc_lexer->line_n);
     }
 }
 
@@ -352,55 +341,53 @@ void holyc_lexer_skip_block_comment(holyc_lexer_T* holyc_lexer)
 }
 
 /**
- * Collect a string token
+ * Collect a string token, the value excludes the quotation marks.
  *
  * @param holyc_lexer_T* holyc_lexer
+ * @param size_t* start
+ * @param size_t* length
  *
- * @return token_T*
+ * @return int
  */
- token_T* holyc_lexer_collect_string(holyc_lexer_T* holyc_lexer)
- {
-     holyc_lexer_expect_char(holyc_lexer, '"');
-     holyc_lexer_advance(holyc_lexer);
-
-     size_t initial_index = holyc_lexer->char_index;
+int holyc_lexer_collect_string(holyc_lexer_T* holyc_lexer, size_t* start, size_t* length)
+{
+    holyc_lexer_expect_char(holyc_lexer, '"');
+    holyc_lexer_advance(holyc_lexer);
 
-     while (holyc_lexer->current_char != '"')
-     {
-         if (holyc_lexer->current_char == '\0')
-         {
-             printf("[Line %d] Missing closing quotation mark\n", holyc_lexer->line_n); exit(1);
-         }
+    *start = holyc_lexer->char_index;
 
-         holyc_lexer_advance(holyc_lexer);
-     }
+    while (holyc_lexer->current_char != '"')
+    {
+        if (holyc_lexer->current_char == '\0')
+        {
+            holyc_parse_error("[Line %d] Missing closing quotation mark\n", holyc_lexer->line_n);
+        }
 
-     size_t length = holyc_lexer->char_index - initial_index + 1;
-     char* buffer = calloc(length, sizeof(char));
-     memcpy(buffer, &holyc_lexer->contents[initial_index], length);
-     buffer[length - 1] = '\0';
+        holyc_lexer_advance(holyc_lexer);
+    }
 
-     holyc_lexer_advance(holyc_lexer);
+    *length = holyc_lexer->char_index - *start;
 
-     token_T* token = init_token(TOKEN_STRING_VALUE, buffer);
-     free(buffer);
+    holyc_lexer_advance(holyc_lexer);
 
-     return token;
- }
+    return TOKEN_STRING_VALUE;
+}
 
 /**
  * Collect a char token
  *
  * @param holyc_lexer_T* holyc_lexer
+ * @param size_t* start
+ * @param size_t* length
  *
- * @return token_T*
+ * @return int
  */
-token_T* holyc_lexer_collect_char(holyc_lexer_T* holyc_lexer)
+int holyc_lexer_collect_char(holyc_lexer_T* holyc_lexer, size_t* start, size_t* length)
 {
     holyc_lexer_expect_char(holyc_lexer, '\'');
     holyc_lexer_advance(holyc_lexer);
-    char* buffer = calloc(1, sizeof(char));
-    buffer[0] = '\0';
+
+    *start = holyc_lexer->char_index;
 
     int c = 0;
 
@@ -408,99 +395,71 @@ token_T* holyc_lexer_collect_char(holyc_lexer_T* holyc_lexer)
     {
         if (c > 1)
         {
-            printf("Error: [Line %d] Chars can only contain one character\n", holyc_lexer->line_n);
-            exit(1);
+            holyc_parse_error("Error: [Line %d] Chars can only contain one character\n", holyc_lexer->line_n);
         }
 
-        char* strchar = holyc_lexer_current_charstr(holyc_lexer);
-        buffer = realloc(buffer, strlen(buffer) + 2);
-        strcat(buffer, strchar);
-        free(strchar);
-
         holyc_lexer_advance(holyc_lexer);
 
         c++;
     }
 
+    *length = holyc_lexer->char_index - *start;
+
     holyc_lexer_advance(holyc_lexer);
 
-    return init_token(TOKEN_CHAR_VALUE, buffer);
+    return TOKEN_CHAR_VALUE;
 }
 
 /**
  * Collect a numeric token
  *
  * @param holyc_lexer_T* holyc_lexer
+ * @param size_t* start
+ * @param size_t* length
  *
- * @return token_T*
+ * @return int
  */
-token_T* holyc_lexer_collect_number(holyc_lexer_T* holyc_lexer)
+int holyc_lexer_collect_number(holyc_lexer_T* holyc_lexer, size_t* start, size_t* length)
 {
     int type = TOKEN_INTEGER_VALUE;
 
-    char* buffer = calloc(1, sizeof(char));
-    buffer[0] = '\0';
-
     while (isdigit(holyc_lexer->current_char))
-    {
-        char* strchar = holyc_lexer_current_charstr(holyc_lexer);
-        buffer = realloc(buffer, strlen(buffer) + 2);
-        strcat(buffer, strchar);
-        free(strchar);
-
         holyc_lexer_advance(holyc_lexer);
-    }
 
     if (holyc_lexer->current_char == '.')
     {
-        char* strchar = holyc_lexer_current_charstr(holyc_lexer);
-        buffer = realloc(buffer, strlen(buffer) + 2);
-        strcat(buffer, strchar);
-        free(strchar);
-
         holyc_lexer_advance(holyc_lexer);
 
         type = TOKEN_FLOAT_VALUE;
 
         while (isdigit(holyc_lexer->current_char))
-        {
-            char* strchar = holyc_lexer_current_charstr(holyc_lexer);
-            buffer = realloc(buffer, strlen(buffer) + 2);
-            strcat(buffer, strchar);
-            free(strchar);
-
             holyc_lexer_advance(holyc_lexer);
-        }
     }
 
-    return init_token(type, buffer);
+    *length = holyc_lexer->char_index - *start;
+
+    return type;
 }
 
 /**
  * Collect an ID token
  *
  * @param holyc_lexer_T* holyc_lexer
+ * @param size_t* start
+ * @param size_t* length
  *
- * @return token_T*
+ * @return int
  */
-token_T* holyc_lexer_collect_id(holyc_lexer_T* holyc_lexer)
+int holyc_lexer_collect_id(holyc_lexer_T* holyc_lexer, size_t* start, size_t* length)
 {
-    size_t initial_index = holyc_lexer->char_index;
-
     while (isalnum(holyc_lexer->current_char) || holyc_lexer->current_char == '_')
     {
         holyc_lexer_advance(holyc_lexer);
     }
 
-    size_t length = holyc_lexer->char_index - initial_index + 1;
-    char* buffer = calloc(length, sizeof(char));
-    memcpy(buffer, &holyc_lexer->contents[initial_index], length);
-    buffer[length - 1] = '\0';
+    *length = holyc_lexer->char_index - *start;
 
-    token_T* token = init_token(TOKEN_ID, buffer);
-    free(buffer);
-
-    return token;
+    return TOKEN_ID;
 }
 
 /**
@@ -0,0 +1,141 @@
+#define _POSIX_C_SOURCE 200809L
+#include "include/holyc_line_reader.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+
+/**
+ * Creates a reader of `fd`, which is not closed by the reader.
+ *
+ * @param int fd
+ *
+ * @return holyc_line_reader_T*
+ */
+holyc_line_reader_T* init_holyc_line_reader(int fd)
+{
+    holyc_line_reader_T* reader = calloc(1, sizeof(struct holyc_LINE_READER_STRUCT));
+    reader->fd = fd;
+    reader->buffer = (void*)0;
+    reader->eof = fd < 0;
+
+    return reader;
+}
+
+/**
+ * Makes room after the unread chars and reads as much as is available,
+ * which is a single line on a terminal.
+ */
+static void fill(holyc_line_reader_T* reader)
+{
+    if (reader->buffer == (void*)0)
+    {
+        reader->size = HOLYC_LINE_READER_SIZE;
+        reader->buffer = malloc(reader->size);
+    }
+    else
+    if (reader->start > 0)
+    {
+        memmove(reader->buffer, &reader->buffer[reader->start], reader->end - reader->start);
+        reader->end -= reader->start;
+        reader->scanned -= reader->start;
+        reader->start = 0;
+    }
+
+    if (reader->end == reader->size)
+    {
+        reader->size *= 2;
+        reader->buffer = realloc(reader->buffer, reader->size);
+    }
+
+    if (reader->buffer == (void*)0)
+    {
+        printf("Error: Out of memory\n");
+        exit(1);
+    }
+
+    ssize_t count;
+
+    do
+    {
+        count = read(reader->fd, &reader->buffer[reader->end], reader->size - reader->end);
+    }
+    while (count < 0 && errno == EINTR);
+
+    if (count <= 0)
+        reader->eof = 1;
+    else
+        reader->end += (size_t) count;
+}
+
+/**
+ * Returns the next line without its newline, or NULL at the end of the
+ * input. The line points into the buffer of the reader and is only valid
+ * until the next call.
+ *
+ * @param holyc_line_reader_T* reader
+ * @param size_t* length the length of the line
+ *
+ * @return const char*
+ */
+const char* holyc_line_reader_next(holyc_line_reader_T* reader, size_t* length)
+{
+    for (;;)
+    {
+        if (reader->buffer)
+        {
+            char* newline = memchr(&reader->buffer[reader->scanned], '\n', reader->end - reader->scanned);
+
+            if (newline)
+            {
+                const char* line = &reader->buffer[reader->start];
+                *length = newline - line;
+                reader->start = reader->scanned = newline - reader->buffer + 1;
+
+                return line;
+            }
+
+            reader->scanned = reader->end;
+
+            if (reader->eof)
+            {
+                // the last line does not need to end with a newline.
+                if (reader->start < reader->end)
+                {
+                    const char* line = &reader->buffer[reader->start];
+                    *length = reader->end - reader->start;
+                    reader->start = reader->end;
+
+                    return line;
+                }
+
+                free(reader->buffer);
+                reader->buffer = (void*)0;
+                reader->start = reader->scanned = reader->end = 0;
+
+                return (void*)0;
+            }
+        }
+        else
+        if (reader->eof)
+        {
+            return (void*)0;
+        }
+
+        fill(reader);
+    }
+}
+
+/**
+ * Deallocates a reader, but does not close its file descriptor.
+ *
+ * @param holyc_line_reader_T* reader
+ */
+void holyc_line_reader_free(holyc_line_reader_T* reader)
+{
+    if (reader->buffer)
+        free(reader->buffer);
+
+    free(reader);
+}
@@ -0,0 +1,193 @@
+#include "include/holyc_map.h"
+#include <stdio.h>
+#include <inttypes.h>
+
+/* keys up to this long are encoded on the stack. */
+#define HOLYC_MAP_KEY_BUFFER_SIZE 64
+
+
+/**
+ * Creates an empty map.
+ *
+ * @return holyc_map_T*
+ */
+holyc_map_T* init_holyc_map()
+{
+    holyc_map_T* map = calloc(1, sizeof(struct holyc_MAP_STRUCT));
+    map_init(&map->entries);
+
+    return map;
+}
+
+/**
+ * @param AST_T* key
+ *
+ * @return unsigned int 1 if `key` can be used as a key of a map
+ */
+unsigned int holyc_map_is_key(AST_T* key)
+{
+    return key && (key->type == AST_STRING || key->type == AST_INTEGER);
+}
+
+/**
+ * Encodes `key` into `buffer` if it fits, returns the encoded key which
+ * must be freed if it is not `buffer`.
+ */
+static char* encode_key(AST_T* key, char* buffer)
+{
+    if (!holyc_map_is_key(key))
+    {
+        printf("Error: [Line %d] Map keys and set items must be strings or ints\n", key ? key->line_n : 0);
+        exit(1);
+    }
+
+    if (key->type == AST_INTEGER)
+    {
+        int64_t value = ast_int_value(key);
+        snprintf(buffer, HOLYC_MAP_KEY_BUFFER_SIZE, "i%" PRId64, value);
+
+        return buffer;
+    }
+
+    size_t length = strlen(key->string_value);
+    char* encoded = length + 2 <= HOLYC_MAP_KEY_BUFFER_SIZE ? buffer : malloc(length + 2);
+    encoded[0] = 's';
+    memcpy(&encoded[1], key->string_value, length + 1);
+
+    return encoded;
+}
+
+/**
+ * @param holyc_map_T* map
+ * @param AST_T* key
+ *
+ * @return holyc_map_entry_T* the entry of `key`, or NULL
+ */
+holyc_map_entry_T* holyc_map_get(holyc_map_T* map, AST_T* key)
+{
+    char buffer[HOLYC_MAP_KEY_BUFFER_SIZE];
+    char* encoded = encode_key(key, buffer);
+
+    holyc_map_entry_T** entry = map_get(&map->entries, encoded);
+
+    if (encoded != buffer)
+        free(encoded);
+
+    return entry ? *entry : (void*)0;
+}
+
+/**
+ * Sets the value of `key`, the map keeps the nodes it is given.
+ *
+ * @param holyc_map_T* map
+ * @param AST_T* key
+ * @param AST_T* value
+ */
+void holyc_map_set(holyc_map_T* map, AST_T* key, AST_T* value)
+{
+    char buffer[HOLYC_MAP_KEY_BUFFER_SIZE];
+    char* encoded = encode_key(key, buffer);
+
+    holyc_map_entry_T** found = map_get(&map->entries, encoded);
+
+    if (found)
+    {
+        (*found)->value = value;
+    }
+    else
+    {
+        holyc_map_entry_T* entry = calloc(1, sizeof(struct holyc_MAP_ENTRY_STRUCT));
+        entry->key = key;
+        entry->value = value;
+        map_set(&map->entries, encoded, entry);
+    }
+
+    if (encoded != buffer)
+        free(encoded);
+}
+
+/**
+ * @param holyc_map_T* map
+ * @param AST_T* key
+ *
+ * @return unsigned int 0 if `key` was not in the map
+ */
+unsigned int holyc_map_remove(holyc_map_T* map, AST_T* key)
+{
+    char buffer[HOLYC_MAP_KEY_BUFFER_SIZE];
+    char* encoded = encode_key(key, buffer);
+
+    holyc_map_entry_T** found = map_get(&map->entries, encoded);
+
+    if (found)
+    {
+        free(*found);
+        map_remove(&map->entries, encoded);
+    }
+
+    if (encoded != buffer)
+        free(encoded);
+
+    return found != (void*)0;
+}
+
+/**
+ * @param holyc_map_T* map
+ *
+ * @return size_t the number of keys
+ */
+size_t holyc_map_size(holyc_map_T* map)
+{
+    return map_size(&map->entries);
+}
+
+/**
+ * Returns the next entry of an iteration started with map_iter(), or
+ * NULL when there are no more entries. Entries come in no particular
+ * order.
+ *
+ * @param holyc_map_T* map
+ * @param map_iter_t* iter
+ *
+ * @return holyc_map_entry_T*
+ */
+holyc_map_entry_T* holyc_map_next(holyc_map_T* map, map_iter_t* iter)
+{
+    const char* encoded = map_next(&map->entries, iter);
+
+    return encoded ? *map_get(&map->entries, encoded) : (void*)0;
+}
+
+/**
+ * @param holyc_map_T* map
+ *
+ * @return holyc_map_T* a copy of `map`, the keys and values are shared
+ */
+holyc_map_T* holyc_map_copy(holyc_map_T* map)
+{
+    holyc_map_T* copy = init_holyc_map();
+    map_iter_t iter = map_iter(&map->entries);
+    holyc_map_entry_T* entry;
+
+    while ((entry = holyc_map_next(map, &iter)))
+        holyc_map_set(copy, entry->key, entry->value);
+
+    return copy;
+}
+
+/**
+ * Deallocates a map, not its keys and values.
+ *
+ * @param holyc_map_T* map
+ */
+void holyc_map_free(holyc_map_T* map)
+{
+    map_iter_t iter = map_iter(&map->entries);
+    holyc_map_entry_T* entry;
+
+    while ((entry = holyc_map_next(map, &iter)))
+        free(entry);
+
+    map_deinit(&map->entries);
+    free(map);
+}
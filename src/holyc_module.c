@@ -0,0 +1,566 @@
+#define _POSIX_C_SOURCE 200809L
+#include "include/holyc_module.h"
+#include "include/holyc_scope.h"
+#include "include/holyc_hashmap.h"
+#include "include/string_utils.h"
+#include "include/holyc_parse_error.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stddef.h>
+#include <string.h>
+
+
+/**
+ * Every AST pointer field that is stored in a module, an edge refers to a
+ * field by its index in this table.
+ */
+static const size_t HOLYC_MODULE_POINTER_FIELDS[] = {
+    offsetof(AST_T, function_call_expr),
+    offsetof(AST_T, variable_value),
+    offsetof(AST_T, variable_type),
+    offsetof(AST_T, variable_assignment_left),
+    offsetof(AST_T, binop_left),
+    offsetof(AST_T, binop_right),
+    offsetof(AST_T, unop_right),
+    offsetof(AST_T, for_init_statement),
+    offsetof(AST_T, for_test_expr),
+    offsetof(AST_T, for_update_statement),
+    offsetof(AST_T, for_body),
+    offsetof(AST_T, function_definition_body),
+    offsetof(AST_T, function_definition_type),
+    offsetof(AST_T, if_expr),
+    offsetof(AST_T, if_body),
+    offsetof(AST_T, if_otherwise),
+    offsetof(AST_T, else_body),
+    offsetof(AST_T, ternary_expr),
+    offsetof(AST_T, ternary_body),
+    offsetof(AST_T, ternary_else_body),
+    offsetof(AST_T, while_expr),
+    offsetof(AST_T, while_body),
+    offsetof(AST_T, return_value),
+    offsetof(AST_T, list_access_pointer),
+    offsetof(AST_T, saved_function_call),
+    offsetof(AST_T, new_value),
+    offsetof(AST_T, iterate_iterable),
+    offsetof(AST_T, iterate_function),
+    offsetof(AST_T, ast),
+    offsetof(AST_T, parent),
+    offsetof(AST_T, assert_expr)
+};
+
+/**
+ * Every dynamic_list_T field of AST nodes that is stored in a module.
+ */
+static const size_t HOLYC_MODULE_LIST_FIELDS[] = {
+    offsetof(AST_T, compound_value),
+    offsetof(AST_T, function_call_arguments),
+    offsetof(AST_T, function_definition_arguments),
+    offsetof(AST_T, object_children),
+    offsetof(AST_T, enum_children),
+    offsetof(AST_T, list_children),
+    offsetof(AST_T, function_definitions),
+    offsetof(AST_T, composition_children)
+};
+
+#define HOLYC_MODULE_POINTER_FIELDS_SIZE (sizeof(HOLYC_MODULE_POINTER_FIELDS) / sizeof(size_t))
+#define HOLYC_MODULE_LIST_FIELDS_SIZE (sizeof(HOLYC_MODULE_LIST_FIELDS) / sizeof(size_t))
+
+/* list items use this instead of a relative index for NULL items. */
+#define HOLYC_MODULE_NULL_ITEM INT32_MIN
+
+#define AST_FIELD(ast, offset) (*(AST_T**)((char*)(ast) + (offset)))
+#define LIST_FIELD(ast, offset) (*(dynamic_list_T**)((char*)(ast) + (offset)))
+
+
+/* ==== writing ==== */
+
+typedef struct holyc_MODULE_BUFFER_STRUCT
+{
+    char* data;
+    size_t size;
+    size_t capacity;
+} holyc_module_buffer_T;
+
+typedef struct holyc_MODULE_WRITER_STRUCT
+{
+    dynamic_list_T* nodes;
+    map_int_t node_indices;
+    map_int_t scope_indices;
+    map_int_t string_offsets;
+    uint32_t scopes_size;
+
+    holyc_module_buffer_T node_records;
+    holyc_module_buffer_T edges;
+    holyc_module_buffer_T lists;
+    holyc_module_buffer_T items;
+    holyc_module_buffer_T scopes;
+    holyc_module_buffer_T strings;
+} holyc_module_writer_T;
+
+static void buffer_push(holyc_module_buffer_T* buffer, const void* data, size_t size)
+{
+    if (buffer->size + size > buffer->capacity)
+    {
+        buffer->capacity = buffer->capacity ? buffer->capacity * 2 : 256;
+
+        while (buffer->size + size > buffer->capacity)
+            buffer->capacity *= 2;
+
+        buffer->data = realloc(buffer->data, buffer->capacity);
+    }
+
+    memcpy(&buffer->data[buffer->size], data, size);
+    buffer->size += size;
+}
+
+static int32_t writer_node_index(holyc_module_writer_T* writer, AST_T* ast)
+{
+    char key[32];
+    sprintf(key, "%p", (void*) ast);
+
+    int* index = map_get(&writer->node_indices, key);
+
+    if (index)
+        return *index;
+
+    int new_index = (int) writer->nodes->size;
+    map_set(&writer->node_indices, key, new_index);
+    dynamic_list_append(writer->nodes, ast);
+
+    return new_index;
+}
+
+static int32_t writer_scope_index(holyc_module_writer_T* writer, holyc_scope_T* scope)
+{
+    if (scope == (void*)0)
+        return -1;
+
+    char key[32];
+    sprintf(key, "%p", (void*) scope);
+
+    int* index = map_get(&writer->scope_indices, key);
+
+    if (index)
+        return *index;
+
+    int new_index = (int) writer->scopes_size++;
+    map_set(&writer->scope_indices, key, new_index);
+
+    holyc_module_scope_T record;
+    record.owner = scope->owner ? writer_node_index(writer, scope->owner) : -1;
+    record.global = scope->global;
+    buffer_push(&writer->scopes, &record, sizeof(record));
+
+    return new_index;
+}
+
+static uint32_t writer_string(holyc_module_writer_T* writer, const char* str)
+{
+    if (str == (void*)0)
+        return 0;
+
+    int* offset = map_get(&writer->string_offsets, str);
+
+    if (offset)
+        return (uint32_t) *offset + 1;
+
+    int new_offset = (int) writer->strings.size;
+    map_set(&writer->string_offsets, str, new_offset);
+    buffer_push(&writer->strings, str, strlen(str) + 1);
+
+    return (uint32_t) new_offset + 1;
+}
+
+static void writer_node(holyc_module_writer_T* writer, int32_t index, AST_T* ast)
+{
+    if (ast->fptr || ast->object_value || ast->typed_list)
+    {
+        printf("Error: [Line %d] Runtime values cannot be stored in a module\n", ast->line_n);
+        exit(1);
+    }
+
+    holyc_module_node_T record;
+    memset(&record, 0, sizeof(record));
+
+    record.type = ast->type;
+    record.line_n = ast->line_n;
+    record.int_value = ast->int_value;
+    record.boolean_value = ast->boolean_value;
+    record.long_int_value = ast->long_int_value;
+    record.is_object_child = ast->is_object_child;
+    record.float_value = ast->float_value;
+    record.char_value = ast->char_value;
+
+    record.string_value = writer_string(writer, ast->string_value);
+    record.variable_name = writer_string(writer, ast->variable_name);
+    record.function_name = writer_string(writer, ast->function_name);
+
+    record.type_value = ast->type_value ? (int32_t) ast->type_value->type : -1;
+
+    for (int i = 0; i < 3; i++)
+        record.type_modifiers[i] = ast->type_value ? ast->type_value->modifiers[i] : 0;
+
+    record.binop_operator_type = ast->binop_operator ? (int32_t) ast->binop_operator->type : -1;
+    record.binop_operator_value = ast->binop_operator ? writer_string(writer, ast->binop_operator->value) : 0;
+    record.unop_operator_type = ast->unop_operator ? (int32_t) ast->unop_operator->type : -1;
+    record.unop_operator_value = ast->unop_operator ? writer_string(writer, ast->unop_operator->value) : 0;
+
+    record.scope = writer_scope_index(writer, (holyc_scope_T*) ast->scope);
+
+    record.first_edge = writer->edges.size / sizeof(holyc_module_edge_T);
+
+    for (size_t f = 0; f < HOLYC_MODULE_POINTER_FIELDS_SIZE; f++)
+    {
+        AST_T* target = AST_FIELD(ast, HOLYC_MODULE_POINTER_FIELDS[f]);
+
+        if (target == (void*)0)
+            continue;
+
+        holyc_module_edge_T edge;
+        edge.field = (uint16_t) f;
+        edge.padding = 0;
+        edge.target = writer_node_index(writer, target) - index;
+        buffer_push(&writer->edges, &edge, sizeof(edge));
+
+        record.edges_size += 1;
+    }
+
+    record.first_list = writer->lists.size / sizeof(holyc_module_list_T);
+
+    for (size_t f = 0; f < HOLYC_MODULE_LIST_FIELDS_SIZE; f++)
+    {
+        dynamic_list_T* list = LIST_FIELD(ast, HOLYC_MODULE_LIST_FIELDS[f]);
+
+        if (list == (void*)0)
+            continue;
+
+        holyc_module_list_T list_record;
+        list_record.field = (uint16_t) f;
+        list_record.padding = 0;
+        list_record.first_item = writer->items.size / sizeof(int32_t);
+        list_record.items_size = list->size;
+        buffer_push(&writer->lists, &list_record, sizeof(list_record));
+
+        for (size_t i = 0; i < list->size; i++)
+        {
+            AST_T* item = (AST_T*) list->items[i];
+            int32_t relative = item ? writer_node_index(writer, item) - index : HOLYC_MODULE_NULL_ITEM;
+            buffer_push(&writer->items, &relative, sizeof(relative));
+        }
+
+        record.lists_size += 1;
+    }
+
+    buffer_push(&writer->node_records, &record, sizeof(record));
+}
+
+/**
+ * Writes the tree (or graph) reachable from `root` to `filename` as a
+ * module, exits on failure.
+ *
+ * @param AST_T* root
+ * @param const char* filename
+ */
+void holyc_module_write(AST_T* root, const char* filename)
+{
+    holyc_module_writer_T writer;
+    memset(&writer, 0, sizeof(writer));
+
+    writer.nodes = init_dynamic_list(sizeof(AST_T*));
+    map_init(&writer.node_indices);
+    map_init(&writer.scope_indices);
+    map_init(&writer.string_offsets);
+
+    writer_node_index(&writer, root);
+
+    // nodes are appended while they are written, in breadth first order.
+    for (size_t i = 0; i < writer.nodes->size; i++)
+        writer_node(&writer, (int32_t) i, (AST_T*) writer.nodes->items[i]);
+
+    holyc_module_header_T header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, HOLYC_MODULE_MAGIC, HOLYC_MODULE_MAGIC_SIZE);
+    header.version = HOLYC_MODULE_VERSION;
+    header.byte_order = HOLYC_MODULE_BYTE_ORDER;
+    header.root = 0;
+    header.nodes_size = writer.nodes->size;
+    header.edges_size = writer.edges.size / sizeof(holyc_module_edge_T);
+    header.lists_size = writer.lists.size / sizeof(holyc_module_list_T);
+    header.items_size = writer.items.size / sizeof(int32_t);
+    header.scopes_size = writer.scopes_size;
+    header.strings_size = writer.strings.size;
+
+    holyc_module_buffer_T* sections[] = {
+        &writer.node_records, &writer.edges, &writer.lists, &writer.items, &writer.scopes, &writer.strings
+    };
+    size_t sections_size = sizeof(sections) / sizeof(holyc_module_buffer_T*);
+
+    header.checksum = HOLYC_FNV1A_INIT;
+
+    for (size_t i = 0; i < sections_size; i++)
+        header.checksum = holyc_fnv1a(header.checksum, sections[i]->data, sections[i]->size);
+
+    FILE* outfile = fopen(filename, "wb");
+
+    if (outfile == (void*)0)
+    {
+        printf("Error: Could not open %s\n", filename);
+        exit(1);
+    }
+
+    unsigned int ok = fwrite(&header, sizeof(header), 1, outfile) == 1;
+
+    for (size_t i = 0; i < sections_size; i++)
+    {
+        if (sections[i]->size)
+            ok = ok && fwrite(sections[i]->data, sections[i]->size, 1, outfile) == 1;
+
+        free(sections[i]->data);
+    }
+
+    if (fclose(outfile) != 0 || !ok)
+    {
+        printf("Error: Could not write to %s\n", filename);
+        exit(1);
+    }
+
+    map_deinit(&writer.node_indices);
+    map_deinit(&writer.scope_indices);
+    map_deinit(&writer.string_offsets);
+    dynamic_list_free(writer.nodes);
+}
+
+
+/* ==== loading ==== */
+
+static void module_error(const char* filename, const char* reason)
+{
+    holyc_parse_error("Error: `%s` is not a valid module, %s\n", filename, reason);
+}
+
+static char* module_string(const char* filename, const char* strings, uint32_t strings_size, uint32_t ref)
+{
+    if (ref == 0)
+        return (void*)0;
+
+    if (ref - 1 >= strings_size)
+        module_error(filename, "string out of range");
+
+    const char* str = &strings[ref - 1];
+    char* copy = calloc(strlen(str) + 1, sizeof(char));
+    strcpy(copy, str);
+
+    return copy;
+}
+
+static AST_T* module_target(const char* filename, AST_T** asts, uint32_t nodes_size, uint32_t index, int32_t relative)
+{
+    int64_t target = (int64_t) index + relative;
+
+    if (target < 0 || target >= nodes_size)
+        module_error(filename, "node out of range");
+
+    return asts[target];
+}
+
+/**
+ * Checks if `filename` starts with the module magic.
+ *
+ * @param const char* filename
+ *
+ * @return unsigned int
+ */
+unsigned int holyc_module_is_module(const char* filename)
+{
+    char magic[HOLYC_MODULE_MAGIC_SIZE];
+    FILE* f = fopen(filename, "rb");
+
+    if (f == (void*)0)
+        return 0;
+
+    size_t n = fread(magic, 1, HOLYC_MODULE_MAGIC_SIZE, f);
+    fclose(f);
+
+    return n == HOLYC_MODULE_MAGIC_SIZE && memcmp(magic, HOLYC_MODULE_MAGIC, HOLYC_MODULE_MAGIC_SIZE) == 0;
+}
+
+/**
+ * Maps a module into memory, validates it and materializes its nodes in
+ * one pass over the node records, without lexing or parsing anything.
+ *
+ * @param const char* filename
+ *
+ * @return AST_T* the root node
+ */
+AST_T* holyc_module_load(const char* filename)
+{
+    int fd = open(filename, O_RDONLY);
+
+    if (fd < 0)
+    {
+        holyc_parse_error("Error: Could not open %s\n", filename);
+    }
+
+    struct stat st;
+
+    if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(holyc_module_header_T))
+        module_error(filename, "file is too small");
+
+    size_t size = (size_t) st.st_size;
+    char* data = mmap((void*)0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (data == MAP_FAILED)
+    {
+        holyc_parse_error("Error: Could not map %s\n", filename);
+    }
+
+    const holyc_module_header_T* header = (const holyc_module_header_T*) data;
+
+    if (memcmp(header->magic, HOLYC_MODULE_MAGIC, HOLYC_MODULE_MAGIC_SIZE) != 0)
+        module_error(filename, "bad magic");
+
+    if (header->byte_order != HOLYC_MODULE_BYTE_ORDER)
+        module_error(filename, "it was written on a machine with a different byte order");
+
+    if (header->version != HOLYC_MODULE_VERSION)
+        module_error(filename, "it was written by a different version");
+
+    uint64_t expected_size = sizeof(holyc_module_header_T)
+        + (uint64_t) header->nodes_size * sizeof(holyc_module_node_T)
+        + (uint64_t) header->edges_size * sizeof(holyc_module_edge_T)
+        + (uint64_t) header->lists_size * sizeof(holyc_module_list_T)
+        + (uint64_t) header->items_size * sizeof(int32_t)
+        + (uint64_t) header->scopes_size * sizeof(holyc_module_scope_T)
+        + header->strings_size;
+
+    if (expected_size != size)
+        module_error(filename, "sizes do not match");
+
+    if (holyc_fnv1a(HOLYC_FNV1A_INIT, &data[sizeof(holyc_module_header_T)], size - sizeof(holyc_module_header_T)) != header->checksum)
+        module_error(filename, "checksum mismatch");
+
+    if (header->nodes_size == 0 || header->root >= header->nodes_size)
+        module_error(filename, "no root node");
+
+    const holyc_module_node_T* nodes = (const holyc_module_node_T*) &data[sizeof(holyc_module_header_T)];
+    const holyc_module_edge_T* edges = (const holyc_module_edge_T*) &nodes[header->nodes_size];
+    const holyc_module_list_T* lists = (const holyc_module_list_T*) &edges[header->edges_size];
+    const int32_t* items = (const int32_t*) &lists[header->lists_size];
+    const holyc_module_scope_T* scope_records = (const holyc_module_scope_T*) &items[header->items_size];
+    const char* strings = (const char*) &scope_records[header->scopes_size];
+
+    if (header->strings_size && strings[header->strings_size - 1] != '\0')
+        module_error(filename, "unterminated string");
+
+    AST_T** asts = calloc(header->nodes_size, sizeof(AST_T*));
+    holyc_scope_T** scopes = calloc(header->scopes_size + 1, sizeof(holyc_scope_T*));
+
+    for (uint32_t i = 0; i < header->nodes_size; i++)
+        asts[i] = init_ast(nodes[i].type);
+
+    for (uint32_t i = 0; i < header->scopes_size; i++)
+    {
+        scopes[i] = init_holyc_scope(scope_records[i].global);
+
+        if (scope_records[i].owner >= 0)
+            scopes[i]->owner = module_target(filename, asts, header->nodes_size, 0, scope_records[i].owner);
+    }
+
+    for (uint32_t i = 0; i < header->nodes_size; i++)
+    {
+        const holyc_module_node_T* record = &nodes[i];
+        AST_T* ast = asts[i];
+
+        ast->line_n = record->line_n;
+        ast->int_value = record->int_value;
+        ast->boolean_value = record->boolean_value;
+        ast->long_int_value = record->long_int_value;
+        ast->is_object_child = record->is_object_child;
+        ast->float_value = record->float_value;
+        ast->char_value = (char) record->char_value;
+
+        ast->string_value = module_string(filename, strings, header->strings_size, record->string_value);
+        ast->variable_name = module_string(filename, strings, header->strings_size, record->variable_name);
+        ast->function_name = module_string(filename, strings, header->strings_size, record->function_name);
+
+        if (record->type_value >= 0)
+        {
+            ast->type_value = init_data_type_as(record->type_value);
+
+            for (int m = 0; m < 3; m++)
+                ast->type_value->modifiers[m] = record->type_modifiers[m];
+        }
+
+        if (record->binop_operator_type >= 0)
+        {
+            char* value = module_string(filename, strings, header->strings_size, record->binop_operator_value);
+            ast->binop_operator = init_token(record->binop_operator_type, value ? value : "");
+            free(value);
+        }
+
+        if (record->unop_operator_type >= 0)
+        {
+            char* value = module_string(filename, strings, header->strings_size, record->unop_operator_value);
+            ast->unop_operator = init_token(record->unop_operator_type, value ? value : "");
+            free(value);
+        }
+
+        if (record->scope >= 0)
+        {
+            if ((uint32_t) record->scope >= header->scopes_size)
+                module_error(filename, "scope out of range");
+
+            ast->scope = (struct holyc_scope_T*) scopes[record->scope];
+        }
+
+        if ((uint64_t) record->first_edge + record->edges_size > header->edges_size)
+            module_error(filename, "edge out of range");
+
+        for (uint32_t e = record->first_edge; e < record->first_edge + record->edges_size; e++)
+        {
+            if (edges[e].field >= HOLYC_MODULE_POINTER_FIELDS_SIZE)
+                module_error(filename, "unknown field");
+
+            AST_FIELD(ast, HOLYC_MODULE_POINTER_FIELDS[edges[e].field]) =
+                module_target(filename, asts, header->nodes_size, i, edges[e].target);
+        }
+
+        if ((uint64_t) record->first_list + record->lists_size > header->lists_size)
+            module_error(filename, "list out of range");
+
+        for (uint32_t l = record->first_list; l < record->first_list + record->lists_size; l++)
+        {
+            const holyc_module_list_T* list_record = &lists[l];
+
+            if (list_record->field >= HOLYC_MODULE_LIST_FIELDS_SIZE)
+                module_error(filename, "unknown field");
+
+            if ((uint64_t) list_record->first_item + list_record->items_size > header->items_size)
+                module_error(filename, "list item out of range");
+
+            dynamic_list_T** list = &LIST_FIELD(ast, HOLYC_MODULE_LIST_FIELDS[list_record->field]);
+
+            if (*list == (void*)0)
+                *list = init_dynamic_list(sizeof(AST_T*));
+
+            for (uint32_t x = list_record->first_item; x < list_record->first_item + list_record->items_size; x++)
+            {
+                AST_T* item = items[x] == HOLYC_MODULE_NULL_ITEM ?
+                    (void*)0 : module_target(filename, asts, header->nodes_size, i, items[x]);
+
+                dynamic_list_append(*list, item);
+            }
+        }
+    }
+
+    AST_T* root = asts[header->root];
+
+    free(asts);
+    free(scopes);
+    munmap(data, size);
+
+    return root;
+}
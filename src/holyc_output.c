@@ -0,0 +1,156 @@
+#include "include/holyc_output.h"
+#include "include/holyc_format.h"
+#include "include/holyc_string.h"
+#include "include/data_type.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+
+/* the buffer of stdout, given to stdio once and kept until exit */
+static char* stdout_buffer = (void*)0;
+static size_t stdout_buffer_size = 0;
+
+/**
+ * Installs the buffer of stdout. setvbuf may only be called before
+ * anything else is done with stdout, so this happens once per process,
+ * when the first runtime is created, and stdout stays fully buffered.
+ */
+static void install_buffer(size_t size)
+{
+    if (stdout_buffer)
+        return;
+
+    stdout_buffer_size = size ? size : HOLYC_OUTPUT_DEFAULT_SIZE;
+    stdout_buffer = malloc(stdout_buffer_size);
+
+    if (stdout_buffer == (void*)0)
+    {
+        printf("Error: Out of memory\n");
+        exit(1);
+    }
+
+    setvbuf(stdout, stdout_buffer, _IOFBF, stdout_buffer_size);
+}
+
+/**
+ * Creates the output and installs a buffer of `size` chars as the buffer
+ * of stdout if this is the first output of the process. `mode` is one of
+ * the HOLYC_OUTPUT_* constants or 0 to pick one depending on whether
+ * stdout is a terminal.
+ *
+ * @param int mode
+ * @param size_t size 0 for HOLYC_OUTPUT_DEFAULT_SIZE
+ *
+ * @return holyc_output_T*
+ */
+holyc_output_T* init_holyc_output(int mode, size_t size)
+{
+    holyc_output_T* output = calloc(1, sizeof(struct holyc_OUTPUT_STRUCT));
+
+    if (mode == 0)
+        mode = isatty(STDOUT_FILENO) ? HOLYC_OUTPUT_LINE_BUFFERED : HOLYC_OUTPUT_FULLY_BUFFERED;
+
+    install_buffer(size);
+
+    output->size = stdout_buffer_size;
+    output->mode = mode;
+
+    return output;
+}
+
+/**
+ * Changes when the output is flushed, the buffer itself stays the same.
+ * Output that is already buffered is written when switching to line
+ * buffering.
+ *
+ * @param holyc_output_T* output
+ * @param int mode
+ */
+void holyc_output_set_mode(holyc_output_T* output, int mode)
+{
+    output->mode = mode;
+
+    if (mode == HOLYC_OUTPUT_LINE_BUFFERED)
+        fflush(stdout);
+}
+
+/**
+ * Writes `length` chars, and flushes them if the output is line buffered
+ * and they contain a newline.
+ *
+ * @param holyc_output_T* output
+ * @param const char* str
+ * @param size_t length
+ */
+void holyc_output_write(holyc_output_T* output, const char* str, size_t length)
+{
+    fwrite(str, sizeof(char), length, stdout);
+
+    if (output->mode == HOLYC_OUTPUT_LINE_BUFFERED && memchr(str, '\n', length))
+        fflush(stdout);
+}
+
+/**
+ * Writes a value the way print prints it, numbers and strings are written
+ * into the buffer without allocating.
+ *
+ * @param holyc_output_T* output
+ * @param AST_T* value
+ */
+void holyc_output_write_value(holyc_output_T* output, AST_T* value)
+{
+    char number[HOLYC_FORMAT_BUFFER_SIZE];
+
+    switch (value->type)
+    {
+        case AST_STRING:
+            holyc_output_write(output, value->string_value, ast_string_length(value));
+            return;
+        case AST_INTEGER:
+            holyc_output_write(output, number, holyc_format_i64(ast_int_value(value), number));
+            return;
+        case AST_FLOAT:
+            holyc_output_write(output, number, holyc_format_float_fixed(value->float_value, number));
+            return;
+        case AST_CHAR:
+            holyc_output_write(output, &value->char_value, 1);
+            return;
+        case AST_BOOLEAN:
+            holyc_output_write(output, number, holyc_format_i64((int) value->boolean_value, number));
+            return;
+        default: break;
+    }
+
+    char* str = ast_to_string(value);
+
+    if (str == (void*)0)
+    {
+        holyc_output_write(output, "(void*)0", 8);
+        return;
+    }
+
+    holyc_output_write(output, str, strlen(str));
+    free(str);
+}
+
+/**
+ * @param holyc_output_T* output
+ */
+void holyc_output_flush(holyc_output_T* output)
+{
+    fflush(stdout);
+}
+
+/**
+ * Flushes and deallocates the output, the buffer of stdout is kept since
+ * stdio uses it until exit.
+ *
+ * @param holyc_output_T* output
+ */
+void holyc_output_free(holyc_output_T* output)
+{
+    fflush(stdout);
+
+    free(output);
+}
@@ -0,0 +1,278 @@
+/**
+ * Tokenizes large sources on a thread pool.
+ *
+ * The contents are split into chunks at newlines, every chunk is scanned
+ * speculatively (assuming it does not start inside of a string or comment)
+ * and chunks where that assumption turns out to be wrong are merged into
+ * their predecessor. The remaining chunks are lexed in parallel and the
+ * resulting token buffers are stitched together into the token buffer of
+ * the lexer.
+ */
+#include "include/holyc_parallel_lexer.h"
+#include "include/holyc_thread_pool.h"
+#include <string.h>
+
+
+enum
+{
+    SCAN_CODE,
+    SCAN_STRING,
+    SCAN_CHAR,
+    SCAN_LINE_COMMENT,
+    SCAN_BLOCK_COMMENT_SKIP,
+    SCAN_BLOCK_COMMENT,
+    SCAN_BLOCK_COMMENT_STAR
+};
+
+typedef struct holyc_LEXER_CHUNK_STRUCT
+{
+    char* contents;
+    size_t start;
+    size_t end;
+
+    int end_state;
+    unsigned int newlines;
+    unsigned int line_n;
+    unsigned int merged;
+
+    holyc_token_buffer_T* tokens;
+} holyc_lexer_chunk_T;
+
+static int is_lexer_whitespace(char c)
+{
+    return c == ' ' || (int) c == 10 || (int) c == 13;
+}
+
+/**
+ * Runs the state machine of the lexer over [start, end) without producing
+ * any tokens, returns the state at `end`.
+ * The block comment states mirror holyc_lexer_skip_block_comment exactly.
+ */
+static int scan_states(const char* contents, size_t start, size_t end, int state, unsigned int* newlines)
+{
+    unsigned int n = 0;
+
+    for (size_t i = start; i < end; i++)
+    {
+        char c = contents[i];
+
+        if (c == '\n')
+            n += 1;
+
+        switch (state)
+        {
+            case SCAN_CODE: {
+                if (c == '"')
+                    state = SCAN_STRING;
+                else
+                if (c == '\'')
+                    state = SCAN_CHAR;
+                else
+                if (c == '#')
+                    state = SCAN_LINE_COMMENT;
+                else
+                if (c == '/' && contents[i + 1] == '/')
+                {
+                    state = SCAN_LINE_COMMENT;
+                    i += 1;
+                }
+                else
+                if (c == '/' && contents[i + 1] == '*')
+                {
+                    state = SCAN_BLOCK_COMMENT_SKIP;
+                    i += 1;
+                }
+            } break;
+            case SCAN_STRING: if (c == '"') state = SCAN_CODE; break;
+            case SCAN_CHAR: if (c == '\'') state = SCAN_CODE; break;
+            case SCAN_LINE_COMMENT: if (c == '\n') state = SCAN_CODE; break;
+            case SCAN_BLOCK_COMMENT_SKIP: state = SCAN_BLOCK_COMMENT; break;
+            case SCAN_BLOCK_COMMENT: if (c == '*') state = SCAN_BLOCK_COMMENT_STAR; break;
+            case SCAN_BLOCK_COMMENT_STAR: state = c == '/' ? SCAN_CODE : SCAN_BLOCK_COMMENT; break;
+        }
+    }
+
+    if (newlines)
+        *newlines = n;
+
+    return state;
+}
+
+static void scan_chunk_job(void* arg)
+{
+    holyc_lexer_chunk_T* chunk = (holyc_lexer_chunk_T*) arg;
+    chunk->end_state = scan_states(chunk->contents, chunk->start, chunk->end, SCAN_CODE, &chunk->newlines);
+}
+
+static void lex_chunk_job(void* arg)
+{
+    holyc_lexer_chunk_T* chunk = (holyc_lexer_chunk_T*) arg;
+
+    holyc_lexer_T* lexer = calloc(1, sizeof(struct holyc_LEXER_STRUCT));
+    lexer->contents = chunk->contents;
+    lexer->contents_length = chunk->end;
+    lexer->char_index = chunk->start;
+    lexer->line_n = chunk->line_n;
+    lexer->current_char = chunk->start < chunk->end ? lexer->contents[chunk->start] : '\0';
+    lexer->tokens = (void*)0;
+
+    chunk->tokens = init_holyc_token_buffer(0, 0);
+    holyc_lexer_tokenize(lexer, chunk->tokens);
+
+    // the contents are owned by the parent lexer.
+    free(lexer);
+}
+
+/**
+ * Picks the chunk boundaries, every chunk starts right after a newline
+ * and the whitespace following it, so that no token spans two chunks.
+ */
+static size_t split_chunks(holyc_lexer_T* holyc_lexer, holyc_lexer_chunk_T* chunks, size_t chunks_size)
+{
+    char* contents = holyc_lexer->contents;
+    size_t length = holyc_lexer->contents_length;
+    size_t n = 0;
+    size_t start = 0;
+
+    for (size_t i = 1; i <= chunks_size; i++)
+    {
+        size_t end = length;
+
+        if (i < chunks_size)
+        {
+            size_t guess = (length / chunks_size) * i;
+
+            if (guess <= start)
+                continue;
+
+            char* newline = memchr(&contents[guess], '\n', length - guess);
+
+            if (newline == (void*)0)
+                continue;
+
+            end = (size_t) (newline - contents) + 1;
+
+            while (end < length && is_lexer_whitespace(contents[end]))
+                end += 1;
+
+            if (end >= length)
+                continue;
+        }
+
+        chunks[n].contents = contents;
+        chunks[n].start = start;
+        chunks[n].end = end;
+        chunks[n].merged = 0;
+        chunks[n].tokens = (void*)0;
+        n += 1;
+
+        start = end;
+    }
+
+    return n;
+}
+
+/**
+ * Lexes the whole contents of the lexer on a thread pool and stores the
+ * tokens on the lexer.
+ *
+ * @param holyc_lexer_T* holyc_lexer
+ */
+void holyc_parallel_lexer_tokenize(holyc_lexer_T* holyc_lexer)
+{
+    holyc_thread_pool_T* pool = init_holyc_thread_pool(0);
+
+    size_t chunks_size = pool->threads_size * 2;
+
+    if (holyc_lexer->contents_length / chunks_size < HOLYC_PARALLEL_LEXER_MIN_CHUNK)
+        chunks_size = holyc_lexer->contents_length / HOLYC_PARALLEL_LEXER_MIN_CHUNK;
+
+    if (chunks_size < 1)
+        chunks_size = 1;
+
+    holyc_lexer_chunk_T* chunks = calloc(chunks_size, sizeof(struct holyc_LEXER_CHUNK_STRUCT));
+    chunks_size = split_chunks(holyc_lexer, chunks, chunks_size);
+
+    /* ==== speculative scan, every chunk assumes it starts in code ==== */
+
+    for (size_t i = 0; i < chunks_size; i++)
+        holyc_thread_pool_submit(pool, scan_chunk_job, &chunks[i]);
+
+    holyc_thread_pool_wait(pool);
+
+    /* ==== validate, merge chunks which actually start inside of a string or comment ==== */
+
+    holyc_lexer_chunk_T* prev = &chunks[0];
+    unsigned int line_n = holyc_lexer->line_n;
+    int state = chunks[0].end_state;
+
+    chunks[0].line_n = line_n;
+    line_n += chunks[0].newlines;
+
+    for (size_t i = 1; i < chunks_size; i++)
+    {
+        holyc_lexer_chunk_T* chunk = &chunks[i];
+
+        if (state != SCAN_CODE)
+        {
+            chunk->merged = 1;
+            prev->end = chunk->end;
+            state = scan_states(chunk->contents, chunk->start, chunk->end, state, (void*)0);
+        }
+        else
+        {
+            chunk->line_n = line_n;
+            state = chunk->end_state;
+            prev = chunk;
+        }
+
+        line_n += chunk->newlines;
+    }
+
+    /* ==== lex the chunks ==== */
+
+    for (size_t i = 0; i < chunks_size; i++)
+        if (!chunks[i].merged)
+            holyc_thread_pool_submit(pool, lex_chunk_job, &chunks[i]);
+
+    holyc_thread_pool_wait(pool);
+    holyc_thread_pool_free(pool);
+
+    /* ==== stitch, only the EOF of the last chunk is kept ==== */
+
+    size_t tokens_size = 0;
+    size_t text_size = 0;
+    size_t last = 0;
+
+    for (size_t i = 0; i < chunks_size; i++)
+    {
+        if (chunks[i].merged)
+            continue;
+
+        tokens_size += chunks[i].tokens->size;
+        text_size += chunks[i].tokens->text_size;
+        last = i;
+    }
+
+    holyc_token_buffer_T* tokens = init_holyc_token_buffer(tokens_size, text_size);
+
+    for (size_t i = 0; i < chunks_size; i++)
+    {
+        if (chunks[i].merged)
+            continue;
+
+        // the EOF is the last token and owns the last char of the text.
+        if (i != last)
+        {
+            chunks[i].tokens->size -= 1;
+            chunks[i].tokens->text_size -= 1;
+        }
+
+        holyc_token_buffer_append(tokens, chunks[i].tokens);
+        holyc_token_buffer_free(chunks[i].tokens);
+    }
+
+    free(chunks);
+
+    holyc_lexer->tokens = tokens;
+}
@@ -0,0 +1,53 @@
+#include "include/holyc_parse_error.h"
+#include <stdarg.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+
+static __thread holyc_parse_error_catcher_T* current_catcher = (void*)0;
+
+/**
+ * Sets the catcher of parse errors of the current thread.
+ *
+ * @param holyc_parse_error_catcher_T* catcher NULL to exit on errors again
+ */
+void holyc_parse_error_catch(holyc_parse_error_catcher_T* catcher)
+{
+    current_catcher = catcher;
+}
+
+/**
+ * @return unsigned int 1 if parse errors of the current thread are caught
+ */
+unsigned int holyc_parse_error_catching()
+{
+    return current_catcher != (void*)0;
+}
+
+/**
+ * Reports a parse error, formatted like printf, and exit(1), or jumps
+ * to the catcher of the current thread.
+ *
+ * @param const char* format
+ */
+void holyc_parse_error(const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+
+    holyc_parse_error_catcher_T* catcher = current_catcher;
+
+    if (catcher)
+    {
+        vsnprintf(catcher->message, HOLYC_PARSE_ERROR_SIZE, format, args);
+        va_end(args);
+
+        current_catcher = (void*)0;
+        longjmp(catcher->jump, 1);
+    }
+
+    vprintf(format, args);
+    va_end(args);
+
+    exit(1);
+}
@@ -1,4 +1,7 @@
 #include "include/holyc_parser.h"
+#include "include/holyc_parallel_lexer.h"
+#include "include/holyc_parse_error.h"
+#include "include/holyc_string.h"
 #include <string.h>
 
 
@@ -17,6 +20,21 @@ const char* VALUE_FALSE = "false";
 const char* VALUE_TRUE = "true";
 const char* VALUE_NULL = "NULL";
 
+/**
+ * Points the current token view at the token at token_index, and the line
+ * of the lexer at the line of that token.
+ */
+static void holyc_parser_load_token(holyc_parser_T* holyc_parser)
+{
+    holyc_token_buffer_T* tokens = holyc_parser->tokens;
+    size_t index = holyc_parser->token_index;
+
+    holyc_parser->current_token_view.type = tokens->kinds[index];
+    holyc_parser->current_token_view.value = holyc_token_buffer_value(tokens, index);
+    holyc_parser->current_token_view.line_n = tokens->lines[index];
+    holyc_parser->holyc_lexer->line_n = tokens->lines[index];
+}
+
 /**
  * Initializes the holyc parser.
  */
@@ -24,45 +42,74 @@ holyc_parser_T* init_holyc_parser(holyc_lexer_T* holyc_lexer)
 {
     holyc_parser_T* holyc_parser = calloc(1, sizeof(struct holyc_PARSER_STRUCT));
     holyc_parser->holyc_lexer = holyc_lexer;
-    holyc_parser->current_token = holyc_lexer_get_next_token(holyc_parser->holyc_lexer);
+
+    if (holyc_lexer->tokens == (void*)0)
+    {
+        // errors in the threads of the parallel lexer could not be caught.
+        if (holyc_lexer->contents_length >= HOLYC_PARALLEL_LEXER_THRESHOLD && !holyc_parse_error_catching())
+        {
+            holyc_parallel_lexer_tokenize(holyc_lexer);
+        }
+        else
+        {
+            holyc_lexer->tokens = init_holyc_token_buffer(0, 0);
+            holyc_lexer_tokenize(holyc_lexer, holyc_lexer->tokens);
+        }
+    }
+
+    holyc_parser->tokens = holyc_lexer->tokens;
+    holyc_parser->token_index = 0;
+    holyc_parser->current_token = &holyc_parser->current_token_view;
     holyc_parser->prev_token = (void*)0;
     holyc_parser->data_type = (void*)0;
+    holyc_parser->include_paths = init_dynamic_list(sizeof(char*));
+
+    holyc_parser_load_token(holyc_parser);
 
     return holyc_parser;
 }
 
+/**
+ * Deallocates the parser, the lexer is not touched.
+ */
+void holyc_parser_free(holyc_parser_T* holyc_parser)
+{
+    for (size_t i = 0; i < holyc_parser->include_paths->size; i++)
+        free(holyc_parser->include_paths->items[i]);
+
+    dynamic_list_free(holyc_parser->include_paths);
+    free(holyc_parser);
+}
+
 // etc
 
 /**
- * Throws a type error and exit(1).
+ * Throws a type error, see holyc_parse_error.
  */
 void holyc_parser_type_error(holyc_parser_T* holyc_parser)
 {
-    printf("[Line %d] Invalid type for assigned value\n", holyc_parser->holyc_lexer->line_n);
-    exit(1);
+    holyc_parse_error("[Line %d] Invalid type for assigned value\n", holyc_parser->holyc_lexer->line_n);
 }
 
 /**
- * Throws a syntax error and exit(1).
+ * Throws a syntax error, see holyc_parse_error.
  */
 void holyc_parser_syntax_error(holyc_parser_T* holyc_parser)
 {
-    printf("[Line %d] Syntax error\n", holyc_parser->holyc_lexer->line_n);
-    exit(1);
+    holyc_parse_error("[Line %d] Syntax error\n", holyc_parser->holyc_lexer->line_n);
 }
 
 /**
- * Throws a unexpected token error and exit(1)
+ * Throws a unexpected token error, see holyc_parse_error.
  */
 void holyc_parser_unexpected_token_error(holyc_parser_T* holyc_parser, int token_type)
 {
-    printf(
+    holyc_parse_error(
         "[Line %d] Unexpected token `%s`, was expecting `%d`.\n",
         holyc_parser->holyc_lexer->line_n,
         holyc_parser->current_token->value,
         token_type
     );
-    exit(1);
 }
 
 /**
@@ -76,6 +123,22 @@ static AST_T* as_object_child(AST_T* ast, AST_T* object)
     return ast;
 }
 
+/**
+ * Checks if a string is a data_type that is also the name of a method,
+ * like `set` in `m.set()`
+ */
+static unsigned int is_container_data_type(char* token_value)
+{
+    return (
+        strcmp(token_value, "deque") == 0 ||
+        strcmp(token_value, "map") == 0 ||
+        strcmp(token_value, "set") == 0 ||
+        strcmp(token_value, "bitset") == 0 ||
+        strcmp(token_value, "heap") == 0 ||
+        strcmp(token_value, "builder") == 0
+    );
+}
+
 /**
  * Checks if a string is a data_type
  */
@@ -91,7 +154,8 @@ static unsigned int is_data_type(char* token_value)
         strcmp(token_value, "object") == 0 ||
         strcmp(token_value, "enum") == 0 ||
         strcmp(token_value, "list") == 0 ||
-        strcmp(token_value, "source") == 0
+        strcmp(token_value, "source") == 0 ||
+        is_container_data_type(token_value)
     );
 }
 
@@ -137,16 +201,50 @@ AST_T* holyc_parser_eat(holyc_parser_T* holyc_parser, int token_type)
     }
     else if (holyc_parser->current_token->type == token_type)
     {
-        if (holyc_parser->prev_token)
-            token_free(holyc_parser->prev_token);
+        holyc_parser->prev_token_view = holyc_parser->current_token_view;
+        holyc_parser->prev_token = &holyc_parser->prev_token_view;
+
+        // the buffer always ends with TOKEN_EOF, which is never moved past.
+        if (holyc_parser->token_index + 1 < holyc_parser->tokens->size)
+            holyc_parser->token_index += 1;
 
-        holyc_parser->prev_token = holyc_parser->current_token;
-        holyc_parser->current_token = holyc_lexer_get_next_token(holyc_parser->holyc_lexer);
+        holyc_parser_load_token(holyc_parser);
     }
 
     return (void*)0;
 }
 
+/**
+ * Returns the type of the token `offset` tokens after the current one,
+ * without consuming anything. Peeking past the end gives TOKEN_EOF.
+ */
+int holyc_parser_peek(holyc_parser_T* holyc_parser, size_t offset)
+{
+    size_t index = holyc_parser->token_index + offset;
+
+    if (index >= holyc_parser->tokens->size)
+        return TOKEN_EOF;
+
+    return holyc_parser->tokens->kinds[index];
+}
+
+/**
+ * Checks if the current token starts a definition. The container types
+ * only do when they are followed by a name or an anonymous function, so
+ * that methods like `m.set()` can share their name with a type.
+ */
+static unsigned int holyc_parser_at_definition(holyc_parser_T* holyc_parser)
+{
+    char* token_value = holyc_parser->current_token->value;
+
+    if (!is_container_data_type(token_value))
+        return is_data_type(token_value) || is_data_type_modifier(token_value);
+
+    int next = holyc_parser_peek(holyc_parser, 1);
+
+    return next == TOKEN_ID || next == TOKEN_ANON_ID;
+}
+
 /**
  * Parses a single statement.
  */
@@ -190,7 +288,7 @@ AST_T* holyc_parser_parse_statement(holyc_parser_T* holyc_parser, holyc_scope_T*
             if (strcmp(token_value, STATEMENT_ASSERT) == 0)
                 return holyc_parser_parse_assert(holyc_parser, scope);
 
-            if (is_data_type(token_value) || is_data_type_modifier(token_value))
+            if (holyc_parser_at_definition(holyc_parser))
                 return holyc_parser_parse_function_definition(holyc_parser, scope);
 
             holyc_parser_eat(holyc_parser, TOKEN_ID);
@@ -225,7 +323,7 @@ AST_T* holyc_parser_parse_statement(holyc_parser_T* holyc_parser, holyc_scope_T*
                 return a;
         } break;
         case TOKEN_NUMBER_VALUE: case TOKEN_STRING_VALUE: case TOKEN_CHAR_VALUE: case TOKEN_FLOAT_VALUE: case TOKEN_INTEGER_VALUE: return holyc_parser_parse_expr(holyc_parser, scope); break;
-        case TOKEN_ANON_ID: { printf("[Line %d] Unexpected token `%s`\n", holyc_parser->holyc_lexer->line_n, holyc_parser->current_token->value); exit(1); } break;
+        case TOKEN_ANON_ID: { holyc_parse_error("[Line %d] Unexpected token `%s`\n", holyc_parser->holyc_lexer->line_n, holyc_parser->current_token->value); } break;
         default: return init_ast_with_line(AST_NOOP, holyc_parser->holyc_lexer->line_n); break;
     }
 
@@ -272,8 +370,7 @@ AST_T* holyc_parser_parse_type(holyc_parser_T* holyc_parser, holyc_scope_T* scop
     {
         if (modifier_index > 3)
         {
-            printf("[Line %d] Too many modifiers\n", holyc_parser->holyc_lexer->line_n);
-            exit(1);
+            holyc_parse_error("[Line %d] Too many modifiers\n", holyc_parser->holyc_lexer->line_n);
         }
 
         int modifier = 0;
@@ -319,6 +416,24 @@ AST_T* holyc_parser_parse_type(holyc_parser_T* holyc_parser, holyc_scope_T* scop
     else
     if (strcmp(token_value, "source") == 0)
         type-> type = DATA_TYPE_SOURCE;
+    else
+    if (strcmp(token_value, "deque") == 0)
+        type-> type = DATA_TYPE_DEQUE;
+    else
+    if (strcmp(token_value, "map") == 0)
+        type-> type = DATA_TYPE_MAP;
+    else
+    if (strcmp(token_value, "set") == 0)
+        type-> type = DATA_TYPE_SET;
+    else
+    if (strcmp(token_value, "bitset") == 0)
+        type-> type = DATA_TYPE_BITSET;
+    else
+    if (strcmp(token_value, "heap") == 0)
+        type-> type = DATA_TYPE_HEAP;
+    else
+    if (strcmp(token_value, "builder") == 0)
+        type-> type = DATA_TYPE_BUILDER;
     
     ast_type->type_value = type;
 
@@ -352,8 +467,7 @@ AST_T* holyc_parser_parse_string(holyc_parser_T* holyc_parser, holyc_scope_T* sc
 {
     AST_T* ast_string = init_ast_with_line(AST_STRING, holyc_parser->holyc_lexer->line_n);
     ast_string->scope = (struct holyc_scope_T*) scope;
-    ast_string->string_value = calloc(strlen(holyc_parser->current_token->value) + 1, sizeof(char));
-    strcpy(ast_string->string_value, holyc_parser->current_token->value);
+    ast_string_set(ast_string, init_holyc_string(holyc_parser->current_token->value, strlen(holyc_parser->current_token->value)));
 
     holyc_parser_eat(holyc_parser, TOKEN_STRING_VALUE);
 
@@ -589,6 +703,50 @@ AST_T* holyc_parser_parse_list(holyc_parser_T* holyc_parser, holyc_scope_T* scop
     return ast_list;
 }
 
+/**
+ * Checks if the brace at the current token opens a map rather than an
+ * object, that is if it is followed by a key and a colon, or if it is
+ * empty and assigned to a map.
+ */
+static unsigned int holyc_parser_is_map(holyc_parser_T* holyc_parser)
+{
+    int key = holyc_parser_peek(holyc_parser, 1);
+
+    if (key == TOKEN_RBRACE)
+        return holyc_parser->data_type && holyc_parser->data_type->type == DATA_TYPE_MAP;
+
+    return (key == TOKEN_STRING_VALUE || key == TOKEN_INTEGER_VALUE || key == TOKEN_ID) &&
+        holyc_parser_peek(holyc_parser, 2) == TOKEN_COLON;
+}
+
+/**
+ * Parses a map literal, { key: value, ... }.
+ * The keys and values are stored in list_children, one after the other.
+ */
+AST_T* holyc_parser_parse_map(holyc_parser_T* holyc_parser, holyc_scope_T* scope)
+{
+    holyc_parser_eat(holyc_parser, TOKEN_LBRACE);
+    AST_T* ast_map = init_ast_with_line(AST_MAP, holyc_parser->holyc_lexer->line_n);
+    ast_map->scope = (struct holyc_scope_T*) scope;
+    ast_map->list_children = init_dynamic_list(sizeof(struct AST_STRUCT*));
+
+    while (holyc_parser->current_token->type != TOKEN_RBRACE)
+    {
+        dynamic_list_append(ast_map->list_children, holyc_parser_parse_expr(holyc_parser, scope));
+        holyc_parser_eat(holyc_parser, TOKEN_COLON);
+        dynamic_list_append(ast_map->list_children, holyc_parser_parse_expr(holyc_parser, scope));
+
+        if (holyc_parser->current_token->type != TOKEN_COMMA)
+            break;
+
+        holyc_parser_eat(holyc_parser, TOKEN_COMMA);
+    }
+
+    holyc_parser_eat(holyc_parser, TOKEN_RBRACE);
+
+    return ast_map;
+}
+
 // math
 
 /**
@@ -683,10 +841,12 @@ AST_T* holyc_parser_parse_factor(holyc_parser_T* holyc_parser, holyc_scope_T* sc
         case TOKEN_FLOAT_VALUE: return holyc_parser_parse_float(holyc_parser, scope); break;
         case TOKEN_STRING_VALUE: return holyc_parser_parse_string(holyc_parser, scope); break;
         case TOKEN_CHAR_VALUE: return holyc_parser_parse_char(holyc_parser, scope); break;
-        case TOKEN_LBRACE: return holyc_parser_parse_object(holyc_parser, scope); break;
+        case TOKEN_LBRACE: return holyc_parser_is_map(holyc_parser) ? holyc_parser_parse_map(holyc_parser, scope) : holyc_parser_parse_object(holyc_parser, scope); break;
         case TOKEN_LBRACKET: return holyc_parser_parse_list(holyc_parser, scope); break;
-        default: printf("Unexpected %s\n", holyc_parser->current_token->value); exit(1); break;
+        default: holyc_parse_error("Unexpected %s\n", holyc_parser->current_token->value); break;
     }
+
+    return init_ast_with_line(AST_NOOP, holyc_parser->holyc_lexer->line_n);
 }
 
 /**
@@ -694,9 +854,7 @@ AST_T* holyc_parser_parse_factor(holyc_parser_T* holyc_parser, holyc_scope_T* sc
  */
 AST_T* holyc_parser_parse_term(holyc_parser_T* holyc_parser, holyc_scope_T* scope)
 {
-    char* token_value = holyc_parser->current_token->value;
-
-    if (is_data_type(token_value) || is_data_type_modifier(token_value)) // this is to be able to have variable definitions inside of function definition parantheses.
+    if (holyc_parser_at_definition(holyc_parser)) // this is to be able to have variable definitions inside of function definition parantheses.
         return holyc_parser_parse_function_definition(holyc_parser, scope);
 
     AST_T* node = holyc_parser_parse_factor(holyc_parser, scope);
@@ -949,7 +1107,7 @@ AST_T* holyc_parser_parse_iterate(holyc_parser_T* holyc_parser, holyc_scope_T* s
 
     AST_T* ast_fname = (void*)0;
 
-    if (is_data_type(holyc_parser->current_token->value) || is_data_type_modifier(holyc_parser->current_token->value))
+    if (holyc_parser_at_definition(holyc_parser))
     {
         /**
          * Here we make the assumption that a private function is being
@@ -1092,6 +1250,19 @@ AST_T* holyc_parser_parse_function_call(holyc_parser_T* holyc_parser, holyc_scop
 
     holyc_parser_eat(holyc_parser, TOKEN_RPAREN);
 
+    // literal include paths can be parsed ahead of time, see holyc_include_cache.c
+    if (
+        expr && expr->type == AST_VARIABLE && strcmp(expr->variable_name, "include") == 0 &&
+        ast_function_call->function_call_arguments->size == 1 &&
+        ((AST_T*) ast_function_call->function_call_arguments->items[0])->type == AST_STRING
+    )
+    {
+        AST_T* ast_path = (AST_T*) ast_function_call->function_call_arguments->items[0];
+        char* path = calloc(strlen(ast_path->string_value) + 1, sizeof(char));
+        strcpy(path, ast_path->string_value);
+        dynamic_list_append(holyc_parser->include_paths, path);
+    }
+
     return ast_function_call;
 }
 
@@ -1171,7 +1342,7 @@ AST_T* holyc_parser_parse_function_definition(holyc_parser_T* holyc_parser, holy
 
             AST_T* child_def = (void*)0;
 
-            if (is_data_type(holyc_parser->current_token->value) || is_data_type_modifier(holyc_parser->current_token->value))
+            if (holyc_parser_at_definition(holyc_parser))
             {
                 child_def = holyc_parser_parse_function_definition(holyc_parser, scope);
             }
@@ -1191,7 +1362,7 @@ AST_T* holyc_parser_parse_function_definition(holyc_parser_T* holyc_parser, holy
             {
                 holyc_parser_eat(holyc_parser, TOKEN_COMMA);
                 
-                if (is_data_type(holyc_parser->current_token->value) || is_data_type_modifier(holyc_parser->current_token->value))
+                if (holyc_parser_at_definition(holyc_parser))
                 {
                     child_def = holyc_parser_parse_function_definition(holyc_parser, scope);
                 }
@@ -1259,8 +1430,10 @@ AST_T* holyc_parser_parse_function_definition(holyc_parser_T* holyc_parser, holy
                 case AST_INTEGER: if (ast_type->type_value->type != DATA_TYPE_INT) holyc_parser_type_error(holyc_parser); break;
                 case AST_FLOAT: if (ast_type->type_value->type != DATA_TYPE_FLOAT) holyc_parser_type_error(holyc_parser); break;
                 case AST_BOOLEAN: if (ast_type->type_value->type != DATA_TYPE_BOOLEAN) holyc_parser_type_error(holyc_parser); break;
-                case AST_LIST: if (ast_type->type_value->type != DATA_TYPE_LIST) holyc_parser_type_error(holyc_parser); break;
+                // containers can be initialized from a list literal.
+                case AST_LIST: if (ast_type->type_value->type != DATA_TYPE_LIST && ast_type->type_value->type != DATA_TYPE_DEQUE && ast_type->type_value->type != DATA_TYPE_SET && ast_type->type_value->type != DATA_TYPE_HEAP) holyc_parser_type_error(holyc_parser); break;
                 case AST_CHAR: if (ast_type->type_value->type != DATA_TYPE_CHAR) holyc_parser_type_error(holyc_parser); break;
+                case AST_MAP: if (ast_type->type_value->type != DATA_TYPE_MAP) holyc_parser_type_error(holyc_parser); break;
                 case AST_COMPOUND: if (ast_type->type_value->type != DATA_TYPE_SOURCE) holyc_parser_type_error(holyc_parser); break;
                 default: /* silence */; break;
             }
@@ -1,7 +1,21 @@
 #include "include/holyc_runtime.h"
 #include "include/holyc_builtins.h"
 #include "include/dl.h"
+#include "include/holyc_include_cache.h"
 #include "include/token.h"
+#include "include/holyc_typed_list.h"
+#include "include/holyc_deque.h"
+#include "include/holyc_map.h"
+#include "include/holyc_bitset.h"
+#include "include/holyc_heap.h"
+#include "include/holyc_sort.h"
+#include "include/holyc_string.h"
+#include "include/holyc_string_search.h"
+#include "include/holyc_format.h"
+#include "include/holyc_output.h"
+#include "include/holyc_line_reader.h"
+#include "include/holyc_writer.h"
+#include <ctype.h>
 #include <string.h>
 
 
@@ -21,8 +35,7 @@ static void _multiple_variable_definitions_error(int line_n, char* variable_name
 
 static AST_T* list_add_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
 {
-    for (int i = 0; i < args->size; i++)
-        dynamic_list_append(self->list_children, args->items[i]);
+    ast_list_append_many(self, args->items, args->size);
 
     return self;
 }
@@ -33,23 +46,1100 @@ static AST_T* list_remove_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T*
 
     AST_T* ast_int = (AST_T*) args->items[0];
 
-    if (ast_int->int_value > self->list_children->size)
+    if (ast_int->int_value < 0 || ast_int->int_value >= ast_list_size(self))
     {
         printf("Index out of range\n");
         exit(1);
     }
 
-    dynamic_list_remove(self->list_children, self->list_children->items[ast_int->int_value], (void*)0);
+    ast_list_remove_at(self, ast_int->int_value);
 
     return self;
 }
 
+/**
+ * Reads the (start) or (start, end) arguments of slice(), `end` defaults
+ * to `length`.
+ */
+static void slice_range(dynamic_list_T* args, size_t length, size_t* start, size_t* end)
+{
+    runtime_expect_args(args, 1, (int[]){ AST_INTEGER });
+
+    int start_value = ((AST_T*) args->items[0])->int_value;
+    int end_value = (int) length;
+
+    if (args->size > 1)
+    {
+        runtime_expect_args(args, 2, (int[]){ AST_INTEGER, AST_INTEGER });
+        end_value = ((AST_T*) args->items[1])->int_value;
+    }
+
+    if (start_value < 0 || end_value < start_value || (size_t) end_value > length)
+    {
+        printf("Slice out of range\n");
+        exit(1);
+    }
+
+    *start = (size_t) start_value;
+    *end = (size_t) end_value;
+}
+
+static AST_T* list_slice_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    size_t start, end;
+    slice_range(args, ast_list_size(self), &start, &end);
+
+    return ast_list_slice(self, start, end);
+}
+
+static AST_T* list_sort_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    runtime_comparator_T* comparator = (void*)0;
+
+    if (args->size > 0)
+    {
+        runtime_expect_args(args, 1, (int[]){ AST_FUNCTION_DEFINITION });
+        comparator = init_runtime_comparator(runtime, (AST_T*) args->items[0]);
+
+        // comparators are called with boxed items.
+        ast_list_unpack(self);
+    }
+
+    if (self->typed_list)
+    {
+        holyc_sort_typed_list(self->typed_list);
+        return self;
+    }
+
+    dynamic_list_T* children = self->list_children;
+
+    // items may still be expressions, they are sorted by their values.
+    for (size_t i = 0; i < children->size; i++)
+    {
+        AST_T* item = (AST_T*) children->items[i];
+        AST_T* value = runtime_visit(runtime, item);
+        children->items[i] = value == item ? value : ast_copy_value(value);
+    }
+
+    if (comparator)
+    {
+        holyc_sort_nodes((AST_T**) children->items, children->size, runtime_comparator_less, comparator);
+        runtime_comparator_free(comparator);
+        ast_list_pack(self);
+    }
+    else
+        holyc_sort_nodes((AST_T**) children->items, children->size, holyc_sort_less_by_value, (void*)0);
+
+    return self;
+}
+
+static AST_T* string_slice_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    size_t start, end;
+    slice_range(args, ast_string_length(self), &start, &end);
+
+    // string_value is used as a NUL terminated string everywhere, so unlike
+    // list slices, string slices copy their chars.
+    AST_T* ast = init_ast(AST_STRING);
+    ast_string_set(ast, init_holyc_string(&self->string_value[start], end - start));
+
+    return ast;
+}
+
+/* ==== string methods ==== */
+
+/**
+ * Returns the chars of a string or char argument of a string method.
+ */
+static const char* string_arg(const char* fname, dynamic_list_T* args, size_t index, size_t* length)
+{
+    AST_T* value = (AST_T*) args->items[index];
+
+    switch (value->type)
+    {
+        case AST_STRING: *length = ast_string_length(value); return value->string_value;
+        case AST_CHAR: *length = 1; return &value->char_value;
+        default: break;
+    }
+
+    printf("Error: %s() expects a string or a char\n", fname);
+    exit(1);
+}
+
+static const char* needle_arg(const char* fname, dynamic_list_T* args, size_t* length)
+{
+    runtime_expect_args(args, 1, (int[]){ AST_ANY });
+
+    const char* needle = string_arg(fname, args, 0, length);
+
+    if (*length == 0)
+    {
+        printf("Error: %s() of an empty string\n", fname);
+        exit(1);
+    }
+
+    return needle;
+}
+
+static AST_T* init_string_value(const char* value, size_t length)
+{
+    AST_T* ast = init_ast(AST_STRING);
+    ast_string_set(ast, init_holyc_string(value, length));
+
+    return ast;
+}
+
+static AST_T* string_find_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    runtime_expect_args(args, 1, (int[]){ AST_ANY });
+
+    size_t needle_length;
+    const char* needle = string_arg("find", args, 0, &needle_length);
+    size_t length = ast_string_length(self);
+    size_t start = 0;
+
+    if (args->size > 1)
+    {
+        runtime_expect_args(args, 2, (int[]){ AST_ANY, AST_INTEGER });
+        int start_value = ((AST_T*) args->items[1])->int_value;
+        start = start_value < 0 ? 0 : (size_t) start_value > length ? length : (size_t) start_value;
+    }
+
+    size_t index = holyc_string_find(&self->string_value[start], length - start, needle, needle_length);
+
+    AST_T* ast_int = init_ast(AST_INTEGER);
+    ast_int->int_value = index == HOLYC_STRING_NOT_FOUND ? -1 : (int) (start + index);
+
+    return ast_int;
+}
+
+static AST_T* string_contains_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    runtime_expect_args(args, 1, (int[]){ AST_ANY });
+
+    size_t needle_length;
+    const char* needle = string_arg("contains", args, 0, &needle_length);
+
+    AST_T* ast_bool = init_ast(AST_BOOLEAN);
+    ast_bool->boolean_value = holyc_string_find(self->string_value, ast_string_length(self), needle, needle_length) != HOLYC_STRING_NOT_FOUND;
+
+    return ast_bool;
+}
+
+static AST_T* string_count_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    size_t needle_length;
+    const char* needle = needle_arg("count", args, &needle_length);
+    size_t length = ast_string_length(self);
+    size_t count = 0;
+
+    if (needle_length == 1)
+    {
+        count = holyc_string_count_char(self->string_value, length, needle[0]);
+    }
+    else
+    {
+        // occurences do not overlap.
+        holyc_string_searcher_T* searcher = init_holyc_string_searcher(needle, needle_length);
+        size_t at = 0;
+        size_t index;
+
+        while ((index = holyc_string_searcher_find(searcher, &self->string_value[at], length - at)) != HOLYC_STRING_NOT_FOUND)
+        {
+            count += 1;
+            at += index + needle_length;
+        }
+
+        holyc_string_searcher_free(searcher);
+    }
+
+    AST_T* ast_int = init_ast(AST_INTEGER);
+    ast_int->int_value = (int) count;
+
+    return ast_int;
+}
+
+static AST_T* string_split_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    const char* str = self->string_value;
+    size_t length = ast_string_length(self);
+    dynamic_list_T* items = init_dynamic_list(sizeof(struct AST_STRUCT*));
+
+    if (args->size == 0)
+    {
+        // without a separator, splits on runs of whitespace.
+        size_t i = 0;
+
+        while (i < length)
+        {
+            while (i < length && isspace((unsigned char) str[i]))
+                i += 1;
+
+            size_t start = i;
+
+            while (i < length && !isspace((unsigned char) str[i]))
+                i += 1;
+
+            if (i > start)
+                dynamic_list_append(items, init_string_value(&str[start], i - start));
+        }
+    }
+    else
+    {
+        size_t separator_length;
+        const char* separator = needle_arg("split", args, &separator_length);
+        holyc_string_searcher_T* searcher = init_holyc_string_searcher(separator, separator_length);
+        size_t at = 0;
+        size_t index;
+
+        while ((index = holyc_string_searcher_find(searcher, &str[at], length - at)) != HOLYC_STRING_NOT_FOUND)
+        {
+            dynamic_list_append(items, init_string_value(&str[at], index));
+            at += index + separator_length;
+        }
+
+        dynamic_list_append(items, init_string_value(&str[at], length - at));
+        holyc_string_searcher_free(searcher);
+    }
+
+    AST_T* ast_list = init_ast(AST_LIST);
+    ast_list_append_many(ast_list, items->items, items->size);
+    dynamic_list_free(items);
+
+    return ast_list;
+}
+
+static AST_T* string_replace_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    runtime_expect_args(args, 2, (int[]){ AST_ANY, AST_ANY });
+
+    size_t needle_length, replacement_length;
+    const char* needle = needle_arg("replace", args, &needle_length);
+    const char* replacement = string_arg("replace", args, 1, &replacement_length);
+    const char* str = self->string_value;
+    size_t length = ast_string_length(self);
+
+    holyc_string_searcher_T* searcher = init_holyc_string_searcher(needle, needle_length);
+    holyc_string_T* result = init_holyc_string((void*)0, 0);
+    size_t at = 0;
+    size_t index;
+
+    while ((index = holyc_string_searcher_find(searcher, &str[at], length - at)) != HOLYC_STRING_NOT_FOUND)
+    {
+        result = holyc_string_append(result, &str[at], index);
+        result = holyc_string_append(result, replacement, replacement_length);
+        at += index + needle_length;
+    }
+
+    result = holyc_string_append(result, &str[at], length - at);
+    holyc_string_searcher_free(searcher);
+
+    AST_T* ast = init_ast(AST_STRING);
+    ast_string_set(ast, result);
+
+    return ast;
+}
+
+static AST_T* string_trim_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    const char* str = self->string_value;
+    size_t start = 0;
+    size_t end = ast_string_length(self);
+
+    while (start < end && isspace((unsigned char) str[start]))
+        start += 1;
+
+    while (end > start && isspace((unsigned char) str[end - 1]))
+        end -= 1;
+
+    return init_string_value(&str[start], end - start);
+}
+
+static AST_T* string_affix_fptr(const char* fname, AST_T* self, dynamic_list_T* args, unsigned int suffix)
+{
+    runtime_expect_args(args, 1, (int[]){ AST_ANY });
+
+    size_t affix_length;
+    const char* affix = string_arg(fname, args, 0, &affix_length);
+    size_t length = ast_string_length(self);
+
+    AST_T* ast_bool = init_ast(AST_BOOLEAN);
+    ast_bool->boolean_value = affix_length <= length &&
+        memcmp(suffix ? &self->string_value[length - affix_length] : self->string_value, affix, affix_length) == 0;
+
+    return ast_bool;
+}
+
+static AST_T* string_starts_with_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    return string_affix_fptr("starts_with", self, args, 0);
+}
+
+static AST_T* string_ends_with_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    return string_affix_fptr("ends_with", self, args, 1);
+}
+
+static holyc_string_T* concat_strings(const char* left, size_t left_length, const char* right, size_t right_length)
+{
+    holyc_string_T* string = init_holyc_string((void*)0, left_length + right_length);
+    memcpy(string->data, left, left_length);
+    memcpy(&string->data[left_length], right, right_length);
+
+    return string;
+}
+
+/**
+ * Formats an int or float that is concatenated to a string into `buffer`,
+ * floats with the fewest digits that read back as the same float.
+ *
+ * @return size_t the length, 0 for other values
+ */
+static size_t format_number(AST_T* value, char* buffer)
+{
+    switch (value->type)
+    {
+        case AST_INTEGER:
+            return holyc_format_i64(ast_int_value(value), buffer);
+        case AST_FLOAT: return holyc_format_float_shortest(value->float_value, buffer);
+        default: return 0;
+    }
+}
+
 static char* create_str(const char* str)
 {
-    char* newstr = calloc(strlen(str) + 1, sizeof(char));
-    strcpy(newstr, str);
+    char* newstr = calloc(strlen(str) + 1, sizeof(char));
+    strcpy(newstr, str);
+
+    return newstr;
+}
+
+/* ==== deque methods ==== */
+
+static AST_T* deque_push_back_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    for (size_t i = 0; i < args->size; i++)
+        holyc_deque_push_back((holyc_deque_T*) self->object_value, ast_copy_value((AST_T*) args->items[i]));
+
+    return self;
+}
+
+static AST_T* deque_push_front_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    for (size_t i = 0; i < args->size; i++)
+        holyc_deque_push_front((holyc_deque_T*) self->object_value, ast_copy_value((AST_T*) args->items[i]));
+
+    return self;
+}
+
+static holyc_deque_T* deque_not_empty(AST_T* self, const char* fname)
+{
+    holyc_deque_T* deque = (holyc_deque_T*) self->object_value;
+
+    if (deque->size == 0)
+    {
+        printf("Error: %s() on an empty deque\n", fname);
+        exit(1);
+    }
+
+    return deque;
+}
+
+static AST_T* deque_pop_back_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    return (AST_T*) holyc_deque_pop_back(deque_not_empty(self, "pop_back"));
+}
+
+static AST_T* deque_pop_front_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    return (AST_T*) holyc_deque_pop_front(deque_not_empty(self, "pop_front"));
+}
+
+static AST_T* deque_front_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    return (AST_T*) holyc_deque_get(deque_not_empty(self, "front"), 0);
+}
+
+static AST_T* deque_back_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    holyc_deque_T* deque = deque_not_empty(self, "back");
+
+    return (AST_T*) holyc_deque_get(deque, deque->size - 1);
+}
+
+static AST_T* deque_clear_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    holyc_deque_clear((holyc_deque_T*) self->object_value);
+
+    return self;
+}
+
+/**
+ * Creates a deque value holding the items of `list`, or an empty one if
+ * `list` is NULL.
+ */
+static AST_T* init_deque_value(runtime_T* runtime, AST_T* list)
+{
+    size_t size = list ? ast_list_size(list) : 0;
+    holyc_deque_T* deque = init_holyc_deque(size);
+
+    for (size_t i = 0; i < size; i++)
+        holyc_deque_push_back(deque, ast_copy_value(runtime_visit(runtime, ast_list_get(list, i))));
+
+    AST_T* ast = init_ast(AST_DEQUE);
+    ast->object_value = deque;
+    ast->function_definitions = runtime->deque_methods;
+
+    return ast;
+}
+
+/* ==== map methods ==== */
+
+static holyc_map_entry_T* map_entry(AST_T* self, AST_T* key, const char* fname)
+{
+    holyc_map_entry_T* entry = holyc_map_get((holyc_map_T*) self->object_value, key);
+
+    if (entry == (void*)0)
+    {
+        char* key_str = ast_to_string(key);
+        printf("Error: %s() of a missing key `%s`\n", fname, key_str);
+        exit(1);
+    }
+
+    return entry;
+}
+
+static AST_T* map_get_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    runtime_expect_args(args, 1, (int[]){ AST_ANY });
+
+    // get(key, default) gives the default instead of failing.
+    if (args->size > 1)
+    {
+        holyc_map_entry_T* entry = holyc_map_get((holyc_map_T*) self->object_value, (AST_T*) args->items[0]);
+        return entry ? entry->value : (AST_T*) args->items[1];
+    }
+
+    return map_entry(self, (AST_T*) args->items[0], "get")->value;
+}
+
+static AST_T* map_set_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    runtime_expect_args(args, 2, (int[]){ AST_ANY, AST_ANY });
+
+    holyc_map_T* map = (holyc_map_T*) self->object_value;
+    AST_T* key = (AST_T*) args->items[0];
+    AST_T* value = ast_copy_value((AST_T*) args->items[1]);
+
+    holyc_map_entry_T* entry = holyc_map_get(map, key);
+
+    if (entry)
+        entry->value = value;
+    else
+        holyc_map_set(map, ast_copy_value(key), value);
+
+    return self;
+}
+
+static AST_T* map_has_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    runtime_expect_args(args, 1, (int[]){ AST_ANY });
+
+    AST_T* ast_bool = init_ast(AST_BOOLEAN);
+    ast_bool->boolean_value = holyc_map_get((holyc_map_T*) self->object_value, (AST_T*) args->items[0]) != (void*)0;
+
+    return ast_bool;
+}
+
+static AST_T* map_remove_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    runtime_expect_args(args, 1, (int[]){ AST_ANY });
+
+    holyc_map_remove((holyc_map_T*) self->object_value, (AST_T*) args->items[0]);
+
+    return self;
+}
+
+static AST_T* map_items_list(runtime_T* runtime, AST_T* self, unsigned int values)
+{
+    holyc_map_T* map = (holyc_map_T*) self->object_value;
+
+    AST_T* ast_list = init_ast(AST_LIST);
+    dynamic_list_T* items = init_dynamic_list(sizeof(struct AST_STRUCT*));
+    dynamic_list_reserve(items, holyc_map_size(map));
+
+    map_iter_t iter = map_iter(&map->entries);
+    holyc_map_entry_T* entry;
+
+    // keys are copied so that changing them does not corrupt the map.
+    while ((entry = holyc_map_next(map, &iter)))
+        dynamic_list_append(items, values ? entry->value : ast_copy_value(entry->key));
+
+    ast_list_append_many(ast_list, items->items, items->size);
+    dynamic_list_free(items);
+
+    return ast_list;
+}
+
+static AST_T* map_keys_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    return map_items_list(runtime, self, 0);
+}
+
+static AST_T* map_values_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    return map_items_list(runtime, self, 1);
+}
+
+static AST_T* init_map_value(runtime_T* runtime)
+{
+    AST_T* ast = init_ast(AST_MAP);
+    ast->object_value = init_holyc_map();
+    ast->function_definitions = runtime->map_methods;
+
+    return ast;
+}
+
+/* ==== set methods ==== */
+
+static void set_add(holyc_map_T* set, AST_T* item)
+{
+    if (holyc_map_get(set, item))
+        return;
+
+    AST_T* copy = ast_copy_value(item);
+    holyc_map_set(set, copy, copy);
+}
+
+static AST_T* set_add_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    runtime_expect_args(args, 1, (int[]){ AST_ANY });
+
+    set_add((holyc_map_T*) self->object_value, (AST_T*) args->items[0]);
+
+    return self;
+}
+
+static AST_T* set_remove_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    runtime_expect_args(args, 1, (int[]){ AST_ANY });
+
+    holyc_map_remove((holyc_map_T*) self->object_value, (AST_T*) args->items[0]);
+
+    return self;
+}
+
+static AST_T* set_values_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    return map_items_list(runtime, self, 0);
+}
+
+static AST_T* init_set_value(runtime_T* runtime, AST_T* list)
+{
+    size_t size = list ? ast_list_size(list) : 0;
+    holyc_map_T* set = init_holyc_map();
+
+    for (size_t i = 0; i < size; i++)
+        set_add(set, runtime_visit(runtime, ast_list_get(list, i)));
+
+    AST_T* ast = init_ast(AST_SET);
+    ast->object_value = set;
+    ast->function_definitions = runtime->set_methods;
+
+    return ast;
+}
+
+/* ==== bitset methods ==== */
+
+static size_t bitset_index(AST_T* self, dynamic_list_T* args, const char* fname)
+{
+    runtime_expect_args(args, 1, (int[]){ AST_INTEGER });
+
+    holyc_bitset_T* bitset = (holyc_bitset_T*) self->object_value;
+    int index = ((AST_T*) args->items[0])->int_value;
+
+    if (index < 0 || index >= bitset->size)
+    {
+        printf("Error: %s() of bit %d in a bitset of %zu bits\n", fname, index, bitset->size);
+        exit(1);
+    }
+
+    return index;
+}
+
+static holyc_bitset_T* bitset_arg(AST_T* self, dynamic_list_T* args, const char* fname)
+{
+    runtime_expect_args(args, 1, (int[]){ AST_BITSET });
+
+    holyc_bitset_T* a = (holyc_bitset_T*) self->object_value;
+    holyc_bitset_T* b = (holyc_bitset_T*) ((AST_T*) args->items[0])->object_value;
+
+    if (a->size != b->size)
+    {
+        printf("Error: %s() of bitsets of %zu and %zu bits\n", fname, a->size, b->size);
+        exit(1);
+    }
+
+    return b;
+}
+
+static AST_T* bitset_set_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    holyc_bitset_set((holyc_bitset_T*) self->object_value, bitset_index(self, args, "set"));
+
+    return self;
+}
+
+static AST_T* bitset_unset_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    holyc_bitset_unset((holyc_bitset_T*) self->object_value, bitset_index(self, args, "unset"));
+
+    return self;
+}
+
+static AST_T* bitset_test_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    AST_T* ast_bool = init_ast(AST_BOOLEAN);
+    ast_bool->boolean_value = holyc_bitset_test((holyc_bitset_T*) self->object_value, bitset_index(self, args, "test"));
+
+    return ast_bool;
+}
+
+static AST_T* bitset_count_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    AST_T* ast_int = init_ast(AST_INTEGER);
+    ast_int->int_value = holyc_bitset_count((holyc_bitset_T*) self->object_value);
+
+    return ast_int;
+}
+
+static AST_T* bitset_result(AST_T* self, holyc_bitset_T* bitset)
+{
+    AST_T* ast = init_ast(AST_BITSET);
+    ast->object_value = bitset;
+    ast->function_definitions = self->function_definitions;
+
+    return ast;
+}
+
+static AST_T* bitset_union_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    holyc_bitset_T* other = bitset_arg(self, args, "union");
+
+    return bitset_result(self, holyc_bitset_union((holyc_bitset_T*) self->object_value, other));
+}
+
+static AST_T* bitset_intersection_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    holyc_bitset_T* other = bitset_arg(self, args, "intersection");
+
+    return bitset_result(self, holyc_bitset_intersection((holyc_bitset_T*) self->object_value, other));
+}
+
+/* ==== heap methods ==== */
+
+static AST_T* heap_push_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    runtime_expect_args(args, 1, (int[]){ AST_ANY });
+
+    holyc_heap_push((holyc_heap_T*) self->object_value, ast_copy_value((AST_T*) args->items[0]));
+
+    return self;
+}
+
+static AST_T* heap_top(AST_T* self, unsigned int pop, const char* fname)
+{
+    holyc_heap_T* heap = (holyc_heap_T*) self->object_value;
+
+    if (holyc_heap_size(heap) == 0)
+    {
+        printf("Error: %s() of an empty heap\n", fname);
+        exit(1);
+    }
+
+    return pop ? holyc_heap_pop(heap) : holyc_heap_peek(heap);
+}
+
+static AST_T* heap_pop_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    return heap_top(self, 1, "pop");
+}
+
+static AST_T* heap_peek_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    return heap_top(self, 0, "peek");
+}
+
+static AST_T* init_heap_value(runtime_T* runtime, AST_T* list)
+{
+    size_t size = list ? ast_list_size(list) : 0;
+    holyc_heap_T* heap = init_holyc_heap((void*)0, (void*)0);
+
+    AST_T** items = calloc(size ? size : 1, sizeof(struct AST_STRUCT*));
+
+    for (size_t i = 0; i < size; i++)
+        items[i] = ast_copy_value(runtime_visit(runtime, ast_list_get(list, i)));
+
+    holyc_heap_push_many(heap, items, size);
+    free(items);
+
+    AST_T* ast = init_ast(AST_HEAP);
+    ast->object_value = heap;
+    ast->function_definitions = runtime->heap_methods;
+
+    return ast;
+}
+
+/* ==== string builder methods ==== */
+
+/**
+ * Returns the chars of `value` to be appended to a string, numbers are
+ * formatted into `buffer`. The chars must be freed if they are neither the
+ * string_value of `value` nor `buffer`.
+ */
+static char* appended_chars(AST_T* value, char* buffer, size_t* length)
+{
+    if (value->type == AST_STRING)
+    {
+        *length = ast_string_length(value);
+        return value->string_value;
+    }
+
+    if (value->type == AST_INTEGER || value->type == AST_FLOAT)
+    {
+        *length = format_number(value, buffer);
+        return buffer;
+    }
+
+    char* str = ast_to_string(value);
+    *length = strlen(str);
+
+    return str;
+}
+
+static AST_T* builder_append_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    runtime_expect_args(args, 1, (int[]){ AST_ANY });
+
+    AST_T* value = (AST_T*) args->items[0];
+    char buffer[HOLYC_FORMAT_BUFFER_SIZE];
+    size_t length;
+    char* str = appended_chars(value, buffer, &length);
+
+    self->object_value = holyc_string_append((holyc_string_T*) self->object_value, str, length);
+
+    if (str != value->string_value && str != buffer)
+        free(str);
+
+    return self;
+}
+
+static AST_T* builder_to_string_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    holyc_string_T* string = (holyc_string_T*) self->object_value;
+
+    AST_T* ast = init_ast(AST_STRING);
+    ast_string_set(ast, init_holyc_string(string->data, string->length));
+
+    return ast;
+}
+
+static AST_T* builder_clear_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    holyc_string_T* string = (holyc_string_T*) self->object_value;
+    string->length = 0;
+    string->data[0] = '\0';
+
+    return self;
+}
+
+static AST_T* init_builder_value(runtime_T* runtime)
+{
+    AST_T* ast = init_ast(AST_BUILDER);
+    ast->object_value = init_holyc_string((void*)0, 0);
+    ast->function_definitions = runtime->builder_methods;
+
+    return ast;
+}
+
+/* ==== line reader methods ==== */
+
+static AST_T* line_reader_next_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    size_t length;
+    const char* line = holyc_line_reader_next((holyc_line_reader_T*) self->object_value, &length);
+
+    if (line == (void*)0)
+        return init_ast(AST_NULL);
+
+    AST_T* ast = init_ast(AST_STRING);
+    ast_string_set(ast, init_holyc_string(line, length));
+
+    return ast;
+}
+
+/**
+ * Returns a string holding `line`. The string of the previous line is
+ * reused, unless something kept a reference to it.
+ */
+static AST_T* line_string(AST_T* previous, const char* line, size_t length)
+{
+    holyc_string_T* header = previous ? ast_string_header(previous) : (void*)0;
+
+    if (header && header->unique)
+    {
+        header->length = 0;
+        ast_string_set(previous, holyc_string_append(header, line, length));
+
+        return previous;
+    }
+
+    header = init_holyc_string(line, length);
+    header->unique = 1;
+
+    AST_T* ast = init_ast(AST_STRING);
+    ast_string_set(ast, header);
+
+    return ast;
+}
+
+/**
+ * Creates a reader of the lines of `fd`, used for file.lines() and stdin.
+ *
+ * @param runtime_T* runtime
+ * @param int fd
+ *
+ * @return AST_T*
+ */
+AST_T* runtime_init_line_reader(runtime_T* runtime, int fd)
+{
+    AST_T* ast = init_ast(AST_LINE_READER);
+    ast->object_value = init_holyc_line_reader(fd);
+    ast->function_definitions = runtime->line_reader_methods;
+
+    return ast;
+}
+
+/* ==== writer methods ==== */
+
+/**
+ * Queues the chars of `value`, a string is only referenced if it is too
+ * large to be copied, so the writer has to be flushed before the string
+ * can change.
+ */
+static void writer_queue_value(holyc_writer_T* writer, AST_T* value)
+{
+    char buffer[HOLYC_FORMAT_BUFFER_SIZE];
+    size_t length;
+    char* str = appended_chars(value, buffer, &length);
+
+    if (str == value->string_value)
+    {
+        holyc_writer_queue(writer, str, length);
+        return;
+    }
+
+    holyc_writer_write(writer, str, length);
+
+    if (str != buffer)
+        free(str);
+}
+
+/**
+ * Writes the values given as arguments, followed by a newline if
+ * `newline` is set.
+ */
+static AST_T* writer_write_values(runtime_T* runtime, AST_T* self, dynamic_list_T* args, unsigned int newline)
+{
+    holyc_writer_T* writer = (holyc_writer_T*) self->object_value;
+
+    for (size_t i = 0; i < args->size; i++)
+        writer_queue_value(writer, (AST_T*) args->items[i]);
+
+    if (newline)
+        holyc_writer_queue(writer, "\n", 1);
+
+    if (writer->chunk_count)
+        holyc_writer_flush(writer);
+
+    return self;
+}
+
+static AST_T* writer_write_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    return writer_write_values(runtime, self, args, 0);
+}
+
+static AST_T* writer_write_line_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    return writer_write_values(runtime, self, args, 1);
+}
+
+/**
+ * Writes every item of a list, each followed by a newline if `newline` is
+ * set. Large strings are queued without being copied and written together
+ * with the buffered chars, typed lists are formatted straight from their
+ * storage.
+ */
+static AST_T* writer_write_list(runtime_T* runtime, AST_T* self, dynamic_list_T* args, unsigned int newline)
+{
+    runtime_expect_args(args, 1, (int[]){ AST_LIST });
+
+    holyc_writer_T* writer = (holyc_writer_T*) self->object_value;
+    AST_T* list = (AST_T*) args->items[0];
+    holyc_typed_list_T* typed_list = list->typed_list;
+
+    if (typed_list == (void*)0)
+    {
+        for (size_t i = 0; i < list->list_children->size; i++)
+        {
+            writer_queue_value(writer, runtime_visit(runtime, (AST_T*) list->list_children->items[i]));
+
+            if (newline)
+                holyc_writer_queue(writer, "\n", 1);
+        }
+    }
+    else
+    if (typed_list->type == HOLYC_TYPED_LIST_CHAR && !newline)
+    {
+        holyc_writer_queue(writer, (const char*) typed_list->data, typed_list->size);
+    }
+    else
+    {
+        char buffer[HOLYC_FORMAT_BUFFER_SIZE];
+
+        for (size_t i = 0; i < typed_list->size; i++)
+        {
+            size_t length = 1;
+
+            switch (typed_list->type)
+            {
+                case HOLYC_TYPED_LIST_INT: length = holyc_format_i64(((int64_t*) typed_list->data)[i], buffer); break;
+                case HOLYC_TYPED_LIST_FLOAT: length = holyc_format_float_shortest((float) ((double*) typed_list->data)[i], buffer); break;
+                default: buffer[0] = ((char*) typed_list->data)[i]; break;
+            }
+
+            if (newline)
+                buffer[length++] = '\n';
+
+            holyc_writer_write(writer, buffer, length);
+        }
+    }
+
+    if (writer->chunk_count)
+        holyc_writer_flush(writer);
+
+    return self;
+}
+
+static AST_T* writer_write_all_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    return writer_write_list(runtime, self, args, 0);
+}
+
+static AST_T* writer_write_lines_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    return writer_write_list(runtime, self, args, 1);
+}
+
+static AST_T* writer_flush_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    holyc_writer_flush((holyc_writer_T*) self->object_value);
+
+    return self;
+}
+
+static AST_T* writer_close_fptr(runtime_T* runtime, AST_T* self, dynamic_list_T* args)
+{
+    holyc_writer_close((holyc_writer_T*) self->object_value);
+
+    return self;
+}
+
+/**
+ * Creates a writer of `fd` with a buffer of `size` chars, used for
+ * writer() and file.writer().
+ *
+ * @param runtime_T* runtime
+ * @param int fd
+ * @param size_t size 0 for the default size
+ * @param unsigned int owns_fd if closing the writer closes `fd`
+ *
+ * @return AST_T*
+ */
+AST_T* runtime_init_writer(runtime_T* runtime, int fd, size_t size, unsigned int owns_fd)
+{
+    AST_T* ast = init_ast(AST_WRITER);
+    ast->object_value = init_holyc_writer(fd, size, owns_fd);
+    ast->function_definitions = runtime->writer_methods;
+
+    return ast;
+}
+
+/**
+ * string += value, appends in place when the variable is the only one
+ * referring to its string, otherwise the variable gets a copy of its own
+ * first. Repeated appends to a variable are amortized O(1).
+ */
+static AST_T* string_variable_append(AST_T* vardef, AST_T* value)
+{
+    AST_T* current = vardef->variable_value;
+    holyc_string_T* header = ast_string_header(current);
 
-    return newstr;
+    char buffer[HOLYC_FORMAT_BUFFER_SIZE];
+    size_t length;
+    char* str = appended_chars(value, buffer, &length);
+
+    if (header == (void*)0 || !header->unique)
+    {
+        header = init_holyc_string(current->string_value, ast_string_length(current));
+        header->unique = 1;
+
+        current = init_ast(AST_STRING);
+        current->line_n = vardef->line_n;
+        vardef->variable_value = current;
+    }
+
+    ast_string_set(current, holyc_string_append(header, str, length));
+
+    if (str != value->string_value && str != buffer)
+        free(str);
+
+    return current;
+}
+
+/**
+ * Containers declared without a value start out empty, and can be
+ * initialized from a list literal.
+ */
+static AST_T* declared_value(runtime_T* runtime, AST_T* vardef, AST_T* value)
+{
+    data_type_T* type = vardef->variable_type ? vardef->variable_type->type_value : (void*)0;
+
+    if (type && type->type == DATA_TYPE_DEQUE && (value == (void*)0 || value->type == AST_LIST))
+        return init_deque_value(runtime, value);
+
+    if (type && type->type == DATA_TYPE_MAP && value == (void*)0)
+        return init_map_value(runtime);
+
+    if (type && type->type == DATA_TYPE_SET && (value == (void*)0 || value->type == AST_LIST))
+        return init_set_value(runtime, value);
+
+    if (type && type->type == DATA_TYPE_HEAP && (value == (void*)0 || value->type == AST_LIST))
+        return init_heap_value(runtime, value);
+
+    if (type && type->type == DATA_TYPE_BUILDER && value == (void*)0)
+        return init_builder_value(runtime);
+
+    return ast_share_value(value) ? value : init_ast(AST_NULL);
+}
+
+static void register_method(dynamic_list_T* methods, const char* fname, struct AST_STRUCT* (*fptr)(struct RUNTIME_STRUCT* runtime, struct AST_STRUCT* self, dynamic_list_T* args))
+{
+    AST_T* fdef = init_ast(AST_FUNCTION_DEFINITION);
+    fdef->function_name = create_str(fname);
+    fdef->fptr = fptr;
+    dynamic_list_append(methods, fdef);
 }
 
 static void collect_and_sweep_garbage(runtime_T* runtime, dynamic_list_T* old_def_list, holyc_scope_T* scope)
@@ -89,13 +1179,9 @@ static void collect_and_sweep_garbage(runtime_T* runtime, dynamic_list_T* old_de
         );
     }
 
-    if (old_def_list->items != (void*)0)
-        free(old_def_list->items);
-    free(old_def_list);
+    dynamic_list_free(old_def_list);
 
-    if (garbage->items != (void*)0)
-        free(garbage->items);
-    free(garbage);
+    dynamic_list_free(garbage);
 }
 
 static AST_T* _runtime_function_call(runtime_T* runtime, AST_T* fcall, AST_T* fdef)
@@ -113,16 +1199,7 @@ static AST_T* _runtime_function_call(runtime_T* runtime, AST_T* fcall, AST_T* fd
     holyc_scope_T* function_definition_body_scope = (holyc_scope_T*) fdef->function_definition_body->scope;
 
     // Clear all existing arguments to prepare for the new definitions
-    for (int i = function_definition_body_scope->variable_definitions->size-1; i > 0; i--)
-    {
-        dynamic_list_remove(
-            function_definition_body_scope->variable_definitions,
-            function_definition_body_scope->variable_definitions->items[i],
-            _ast_free
-        );
-
-        function_definition_body_scope->variable_definitions->size = 0;
-    }
+    holyc_scope_clear_variable_definitions(function_definition_body_scope);
 
     for (int x = 0; x < fcall->function_call_arguments->size; x++)
     {
@@ -156,6 +1233,8 @@ static AST_T* _runtime_function_call(runtime_T* runtime, AST_T* fcall, AST_T* fd
         if (new_variable_def->variable_value == (void*)0)
             new_variable_def->variable_value = runtime_visit(runtime, ast_arg);
 
+        ast_share_value(new_variable_def->variable_value);
+
         new_variable_def->variable_name = arg_name;
 
         dynamic_list_append(function_definition_body_scope->variable_definitions, new_variable_def);
@@ -164,6 +1243,86 @@ static AST_T* _runtime_function_call(runtime_T* runtime, AST_T* fcall, AST_T* fd
     return runtime_visit(runtime, fdef->function_definition_body);
 }
 
+/**
+ * Calls a function definition with already visited arguments, used by
+ * builtins that take a function, such as heap comparators.
+ *
+ * @param runtime_T* runtime
+ * @param AST_T* fdef
+ * @param dynamic_list_T* args
+ *
+ * @return AST_T* the returned value, or NULL
+ */
+AST_T* runtime_call_function(runtime_T* runtime, AST_T* fdef, dynamic_list_T* args)
+{
+    if (fdef->fptr)
+        return runtime_visit(runtime, fdef->fptr(runtime, fdef, args));
+
+    if (fdef->function_definition_body == (void*)0)
+    {
+        printf("Error: [Line %d] %s can not be called from a builtin\n", fdef->line_n, fdef->function_name);
+        exit(1);
+    }
+
+    // the call node is only read, so it does not need to outlive the call.
+    AST_T fcall;
+    memset(&fcall, 0, sizeof(fcall));
+    fcall.type = AST_FUNCTION_CALL;
+    fcall.line_n = fdef->line_n;
+    fcall.function_call_arguments = args;
+
+    return _runtime_function_call(runtime, &fcall, fdef);
+}
+
+/**
+ * @param runtime_T* runtime
+ * @param AST_T* fdef the function comparing two items
+ *
+ * @return runtime_comparator_T*
+ */
+runtime_comparator_T* init_runtime_comparator(runtime_T* runtime, AST_T* fdef)
+{
+    runtime_comparator_T* comparator = calloc(1, sizeof(struct RUNTIME_COMPARATOR_STRUCT));
+    comparator->runtime = runtime;
+    comparator->fdef = fdef;
+    comparator->args = init_dynamic_list(sizeof(struct AST_STRUCT*));
+
+    return comparator;
+}
+
+/**
+ * Calls the comparator given as `context` with `a` and `b`, usable as a
+ * holyc_sort_less_T or holyc_heap_less_T.
+ *
+ * @param void* context a runtime_comparator_T*
+ * @param AST_T* a
+ * @param AST_T* b
+ *
+ * @return unsigned int
+ */
+unsigned int runtime_comparator_less(void* context, AST_T* a, AST_T* b)
+{
+    runtime_comparator_T* comparator = (runtime_comparator_T*) context;
+
+    // the argument list is reused for every comparison.
+    comparator->args->size = 0;
+    dynamic_list_append(comparator->args, a);
+    dynamic_list_append(comparator->args, b);
+
+    AST_T* result = runtime_call_function(comparator->runtime, comparator->fdef, comparator->args);
+
+    return result != (void*)0 && _boolean_evaluation(result);
+}
+
+/**
+ * @param runtime_comparator_T* comparator
+ */
+void runtime_comparator_free(runtime_comparator_T* comparator)
+{
+    dynamic_list_free(comparator->args);
+    free(comparator);
+}
+
 AST_T* runtime_register_global_function(runtime_T* runtime, char* fname, struct AST_STRUCT* (*fptr)(struct RUNTIME_STRUCT* runtime, struct AST_STRUCT* self, dynamic_list_T* args))
 {
   AST_T* fdef = init_ast(AST_FUNCTION_DEFINITION);
@@ -184,26 +1343,108 @@ AST_T* runtime_register_global_variable(runtime_T* runtime, char* vname, char* v
   return vdef;
 }
 
+/**
+ * Reads the size of the buffer of stdout from the environment, it can only
+ * be picked before anything is written.
+ *
+ * @return size_t 0 for the default size
+ */
+static size_t stdout_buffer_size(void)
+{
+    const char* value = getenv(HOLYC_OUTPUT_SIZE_VARIABLE);
+    int size = value ? atoi(value) : 0;
+
+    return size > 0 ? (size_t) size : 0;
+}
+
 runtime_T* init_runtime()
 {
     runtime_T* runtime = calloc(1, sizeof(struct RUNTIME_STRUCT));
     runtime->scope = init_holyc_scope(1);
     runtime->list_methods = init_dynamic_list(sizeof(struct AST_STRUCT*));
+    runtime->string_methods = init_dynamic_list(sizeof(struct AST_STRUCT*));
+    runtime->deque_methods = init_dynamic_list(sizeof(struct AST_STRUCT*));
+    runtime->map_methods = init_dynamic_list(sizeof(struct AST_STRUCT*));
+    runtime->set_methods = init_dynamic_list(sizeof(struct AST_STRUCT*));
+    runtime->bitset_methods = init_dynamic_list(sizeof(struct AST_STRUCT*));
+    runtime->heap_methods = init_dynamic_list(sizeof(struct AST_STRUCT*));
+    runtime->builder_methods = init_dynamic_list(sizeof(struct AST_STRUCT*));
+    runtime->line_reader_methods = init_dynamic_list(sizeof(struct AST_STRUCT*));
+    runtime->writer_methods = init_dynamic_list(sizeof(struct AST_STRUCT*));
     runtime->stdout_buffer = (void*)0;
+    runtime->output = init_holyc_output(0, stdout_buffer_size());
+    runtime->include_cache = init_holyc_include_cache();
 
     INITIALIZED_NOOP = init_ast(AST_NOOP);
 
     init_builtins(runtime);
 
-    AST_T* LIST_ADD_FUNCTION_DEFINITION = init_ast(AST_FUNCTION_DEFINITION);
-    LIST_ADD_FUNCTION_DEFINITION->function_name = create_str("add");
-    LIST_ADD_FUNCTION_DEFINITION->fptr = list_add_fptr;
-    dynamic_list_append(runtime->list_methods, LIST_ADD_FUNCTION_DEFINITION);
-
-    AST_T* LIST_REMOVE_FUNCTION_DEFINITION = init_ast(AST_FUNCTION_DEFINITION);
-    LIST_REMOVE_FUNCTION_DEFINITION->function_name = create_str("remove");
-    LIST_REMOVE_FUNCTION_DEFINITION->fptr = list_remove_fptr;
-    dynamic_list_append(runtime->list_methods, LIST_REMOVE_FUNCTION_DEFINITION);
+    register_method(runtime->list_methods, "add", list_add_fptr);
+    register_method(runtime->list_methods, "remove", list_remove_fptr);
+    register_method(runtime->list_methods, "slice", list_slice_fptr);
+    register_method(runtime->list_methods, "sort", list_sort_fptr);
+
+    register_method(runtime->string_methods, "slice", string_slice_fptr);
+    register_method(runtime->string_methods, "find", string_find_fptr);
+    register_method(runtime->string_methods, "contains", string_contains_fptr);
+    register_method(runtime->string_methods, "count", string_count_fptr);
+    register_method(runtime->string_methods, "split", string_split_fptr);
+    register_method(runtime->string_methods, "replace", string_replace_fptr);
+    register_method(runtime->string_methods, "trim", string_trim_fptr);
+    register_method(runtime->string_methods, "starts_with", string_starts_with_fptr);
+    register_method(runtime->string_methods, "ends_with", string_ends_with_fptr);
+
+    register_method(runtime->deque_methods, "push_back", deque_push_back_fptr);
+    register_method(runtime->deque_methods, "push_front", deque_push_front_fptr);
+    register_method(runtime->deque_methods, "pop_back", deque_pop_back_fptr);
+    register_method(runtime->deque_methods, "pop_front", deque_pop_front_fptr);
+    register_method(runtime->deque_methods, "front", deque_front_fptr);
+    register_method(runtime->deque_methods, "back", deque_back_fptr);
+    register_method(runtime->deque_methods, "clear", deque_clear_fptr);
+
+    register_method(runtime->map_methods, "get", map_get_fptr);
+    register_method(runtime->map_methods, "set", map_set_fptr);
+    register_method(runtime->map_methods, "has", map_has_fptr);
+    register_method(runtime->map_methods, "remove", map_remove_fptr);
+    register_method(runtime->map_methods, "keys", map_keys_fptr);
+    register_method(runtime->map_methods, "values", map_values_fptr);
+
+    register_method(runtime->set_methods, "add", set_add_fptr);
+    register_method(runtime->set_methods, "remove", set_remove_fptr);
+    register_method(runtime->set_methods, "has", map_has_fptr);
+    register_method(runtime->set_methods, "values", set_values_fptr);
+
+    register_method(runtime->bitset_methods, "set", bitset_set_fptr);
+    register_method(runtime->bitset_methods, "unset", bitset_unset_fptr);
+    register_method(runtime->bitset_methods, "test", bitset_test_fptr);
+    register_method(runtime->bitset_methods, "count", bitset_count_fptr);
+    register_method(runtime->bitset_methods, "union", bitset_union_fptr);
+    register_method(runtime->bitset_methods, "intersection", bitset_intersection_fptr);
+
+    register_method(runtime->heap_methods, "push", heap_push_fptr);
+    register_method(runtime->heap_methods, "pop", heap_pop_fptr);
+    register_method(runtime->heap_methods, "peek", heap_peek_fptr);
+
+    register_method(runtime->builder_methods, "append", builder_append_fptr);
+    register_method(runtime->builder_methods, "to_string", builder_to_string_fptr);
+    register_method(runtime->builder_methods, "clear", builder_clear_fptr);
+
+    register_method(runtime->line_reader_methods, "next", line_reader_next_fptr);
+
+    register_method(runtime->writer_methods, "write", writer_write_fptr);
+    register_method(runtime->writer_methods, "write_line", writer_write_line_fptr);
+    register_method(runtime->writer_methods, "write_all", writer_write_all_fptr);
+    register_method(runtime->writer_methods, "write_lines", writer_write_lines_fptr);
+    register_method(runtime->writer_methods, "flush", writer_flush_fptr);
+    register_method(runtime->writer_methods, "close", writer_close_fptr);
+
+    // the lines of stdin, shared with input().
+    runtime->stdin_reader = runtime_init_line_reader(runtime, 0);
+
+    AST_T* stdin_def = init_ast(AST_VARIABLE_DEFINITION);
+    stdin_def->variable_name = create_str("stdin");
+    stdin_def->variable_value = runtime->stdin_reader;
+    dynamic_list_append(runtime->scope->variable_definitions, stdin_def);
 
     return runtime;
 }
@@ -247,6 +1488,14 @@ AST_T* runtime_visit(runtime_T* runtime, AST_T* node)
         case AST_NEW: return runtime_visit_new(runtime, node); break;
         case AST_ITERATE: return runtime_visit_iterate(runtime, node); break;
         case AST_ASSERT: return runtime_visit_assert(runtime, node); break;
+        case AST_DEQUE: return node; break;
+        case AST_MAP: return runtime_visit_map(runtime, node); break;
+        case AST_SET: return node; break;
+        case AST_BITSET: return node; break;
+        case AST_HEAP: return node; break;
+        case AST_BUILDER: return node; break;
+        case AST_LINE_READER: return node; break;
+        case AST_WRITER: return node; break;
         default: printf("Uncaught statement %d\n", node->type); exit(1); break;
     }
 }
@@ -260,7 +1509,7 @@ unsigned int _boolean_evaluation(AST_T* node)
         case AST_INTEGER: return node->int_value > 0; break;
         case AST_FLOAT: return node->float_value > 0; break;
         case AST_BOOLEAN: return node->boolean_value; break;
-        case AST_STRING: return strlen(node->string_value) > 0; break;
+        case AST_STRING: return node->string_value[0] != '\0'; break;
         default: return 0; break;
     }
 }
@@ -291,6 +1540,115 @@ AST_T* get_variable_definition_by_name(runtime_T* runtime, holyc_scope_T* scope,
 
 /* ==== end of helpers ==== */
 
+/**
+ * Visits a parsed script and then drops the variables and functions that
+ * it defined in the global scope, so that the runtime can run it or other
+ * scripts again. The definitions are in the tree and are visited again
+ * on the next run. Other state of the runtime is not reset.
+ *
+ * @param runtime_T* runtime
+ * @param AST_T* node the parsed script
+ */
+void runtime_run_script(runtime_T* runtime, AST_T* node)
+{
+    holyc_scope_T* scope = runtime->scope;
+    size_t variables_size = scope->variable_definitions->size;
+    size_t functions_size = scope->function_definitions->size;
+
+    runtime_visit(runtime, node);
+
+    scope->variable_definitions->size = variables_size;
+    scope->function_definitions->size = functions_size;
+}
+
+/**
+ * Visits an included tree. The tree comes from the include cache and may
+ * have been run before, definitions it made then that are still in their
+ * scope keep their values, like those of a file that is parsed again.
+ *
+ * @param runtime_T* runtime
+ * @param AST_T* node the parsed file
+ *
+ * @return AST_T* the value the file returned, or a noop
+ */
+AST_T* runtime_run_include(runtime_T* runtime, AST_T* node)
+{
+    unsigned int pass = runtime->definition_pass;
+    runtime->definition_pass = ++runtime->definition_passes;
+
+    AST_T* visited = runtime_visit(runtime, node);
+
+    runtime->definition_pass = pass;
+
+    // the caller visits the result, the tree must not be run twice.
+    return visited == node || visited == (void*)0 ? INITIALIZED_NOOP : visited;
+}
+
+/**
+ * Sets the global list `argv` to the path of the script followed by its
+ * arguments.
+ *
+ * @param runtime_T* runtime
+ * @param int argc
+ * @param char** argv
+ */
+void runtime_set_args(runtime_T* runtime, int argc, char** argv)
+{
+    AST_T* vdef = get_variable_definition_by_name(runtime, runtime->scope, "argv");
+
+    if (vdef == (void*)0)
+    {
+        vdef = init_ast(AST_VARIABLE_DEFINITION);
+        vdef->variable_name = create_str("argv");
+        dynamic_list_append(runtime->scope->variable_definitions, vdef);
+    }
+
+    vdef->variable_value = init_ast(AST_LIST);
+
+    for (int i = 0; i < argc; i++)
+    {
+        AST_T* arg = init_string_value(argv[i], strlen(argv[i]));
+        ast_list_append_many(vdef->variable_value, (void**) &arg, 1);
+    }
+}
+
+/**
+ * Runs `node` once for every line of stdin, with the line in the global
+ * variable `line`, used for -n and -p. The script is parsed once and the
+ * runtime is kept between lines, but the variables and functions that the
+ * script defines are dropped after every line.
+ *
+ * @param runtime_T* runtime
+ * @param AST_T* node the parsed script
+ * @param unsigned int print_lines if `line` is printed after every line
+ */
+void runtime_visit_lines(runtime_T* runtime, AST_T* node, unsigned int print_lines)
+{
+    holyc_line_reader_T* reader = (holyc_line_reader_T*) runtime->stdin_reader->object_value;
+
+    AST_T* line_def = init_ast(AST_VARIABLE_DEFINITION);
+    line_def->variable_name = create_str("line");
+    dynamic_list_append(runtime->scope->variable_definitions, line_def);
+
+    AST_T* line_value = (void*)0;
+    const char* line;
+    size_t length;
+
+    while ((line = holyc_line_reader_next(reader, &length)) != (void*)0)
+    {
+        line_value = line_string(line_value, line, length);
+        line_def->variable_value = line_value;
+
+        runtime_run_script(runtime, node);
+
+        if (print_lines)
+        {
+            holyc_output_write_value(runtime->output, line_def->variable_value);
+            holyc_output_write(runtime->output, "\n", 1);
+        }
+    }
+}
+
 AST_T* runtime_visit_variable(runtime_T* runtime, AST_T* node)
 {
     holyc_scope_T* local_scope = (holyc_scope_T*) node->scope;
@@ -360,7 +1718,10 @@ AST_T* runtime_visit_variable(runtime_T* runtime, AST_T* node)
             if (variable_definition)
             {
                 AST_T* value = runtime_visit(runtime, variable_definition->variable_value);
-                value->type_value = variable_definition->variable_type->type_value;
+
+                // the variables given to iterate functions have no declared type.
+                if (variable_definition->variable_type)
+                    value->type_value = variable_definition->variable_type->type_value;
 
                 return value;
             }
@@ -389,7 +1750,9 @@ AST_T* runtime_visit_variable(runtime_T* runtime, AST_T* node)
                 if (variable_definition)
                 {
                     AST_T* value = runtime_visit(runtime, variable_definition->variable_value);
-                    value->type_value = variable_definition->variable_type->type_value;
+
+                    if (variable_definition->variable_type)
+                        value->type_value = variable_definition->variable_type->type_value;
 
                     return value;
                 }
@@ -408,6 +1771,53 @@ AST_T* runtime_visit_variable(runtime_T* runtime, AST_T* node)
     printf("Error: [Line %d] Undefined variable %s\n", node->line_n, node->variable_name); exit(1);
 }
 
+/**
+ * Copies the value of `expr` if `expr` is a literal, before it is stored
+ * in a variable. Scalars and lists are modified in place, and the parsed
+ * literal is visited again by loops, -n and servers.
+ */
+static AST_T* stored_value(AST_T* expr, AST_T* value)
+{
+    if (value != expr)
+        return value;
+
+    if (value->type != AST_LIST)
+        return ast_copy_value(value);
+
+    // the items are expressions of the literal, they are shared like those of a slice.
+    AST_T* list = ast_list_slice(value, 0, ast_list_size(value));
+    list->function_definitions = value->function_definitions;
+
+    return list;
+}
+
+static unsigned int scope_lists_definition(holyc_scope_T* scope, AST_T* node)
+{
+    for (int i = 0; i < scope->variable_definitions->size; i++)
+    {
+        if (scope->variable_definitions->items[i] == node)
+            return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * Creates the definition that is made when an included tree defines a
+ * variable that it defined in an earlier run and that is still in its
+ * scope, so that the first definition keeps its value.
+ */
+static AST_T* redefinition(AST_T* node)
+{
+    AST_T* ast = init_ast_with_line(AST_VARIABLE_DEFINITION, node->line_n);
+    ast->scope = node->scope;
+    ast->variable_name = node->variable_name;
+    ast->variable_type = node->variable_type;
+    ast->saved_function_call = node->saved_function_call;
+
+    return ast;
+}
+
 AST_T* runtime_visit_variable_definition(runtime_T* runtime, AST_T* node)
 {
     if ((holyc_scope_T*)node->scope == (holyc_scope_T*)runtime->scope)
@@ -439,23 +1849,25 @@ AST_T* runtime_visit_variable_definition(runtime_T* runtime, AST_T* node)
             _multiple_variable_definitions_error(node->line_n, node->variable_name);
     }
 
+    // the initializer is kept, so that a definition that is visited again
+    // (in a loop or for every line with -n) is initialized again.
+    if (node->saved_function_call == (void*) 0)
+        node->saved_function_call = node->variable_value;
+
+    if (node->definition_pass != runtime->definition_pass && scope_lists_definition(get_scope(runtime, node), node))
+        node = redefinition(node);
+
+    node->definition_pass = runtime->definition_pass;
+
     if (node->saved_function_call != (void*) 0)
     {
-        node->variable_value = runtime_visit(runtime, node->saved_function_call);
+        AST_T* value = stored_value(node->saved_function_call, runtime_visit(runtime, node->saved_function_call));
+
+        node->variable_value = declared_value(runtime, node, value);
     }
     else
     {
-        if (node->variable_value)
-        {
-            if (node->variable_value->type == AST_FUNCTION_CALL)
-                node->saved_function_call = node->variable_value;
-
-            node->variable_value = runtime_visit(runtime, node->variable_value);
-        }
-        else
-        {
-            node->variable_value = init_ast(AST_NULL);
-        }
+        node->variable_value = declared_value(runtime, node, (void*)0);
     }
 
     dynamic_list_append(get_scope(runtime, node)->variable_definitions, node);
@@ -484,12 +1896,12 @@ AST_T* runtime_visit_variable_assignment(runtime_T* runtime, AST_T* node)
 
                 if (strcmp(object_var_def->variable_name, left->variable_name) == 0)
                 {
-                    value = runtime_visit(runtime, node->variable_value);
+                    value = stored_value(node->variable_value, runtime_visit(runtime, node->variable_value));
 
                     if (value->type == AST_FLOAT)
                         value->int_value = (int) value->float_value;
 
-                    object_var_def->variable_value = value;
+                    object_var_def->variable_value = ast_share_value(value);
                     return value;
                 }
             }
@@ -506,12 +1918,12 @@ AST_T* runtime_visit_variable_assignment(runtime_T* runtime, AST_T* node)
 
         if (variable_definition != (void*) 0)
         {
-            value = runtime_visit(runtime, node->variable_value);
+            value = stored_value(node->variable_value, runtime_visit(runtime, node->variable_value));
 
             if (value->type == AST_FLOAT)
                 value->int_value = (int) value->float_value;
 
-            variable_definition->variable_value = value;
+            variable_definition->variable_value = ast_share_value(value);
             return value;
         }
     }
@@ -526,12 +1938,12 @@ AST_T* runtime_visit_variable_assignment(runtime_T* runtime, AST_T* node)
 
         if (variable_definition != (void*) 0)
         {
-            value = runtime_visit(runtime, node->variable_value);
+            value = stored_value(node->variable_value, runtime_visit(runtime, node->variable_value));
 
             if (value->type == AST_FLOAT)
                 value->int_value = (int) value->float_value;
 
-            variable_definition->variable_value = value;
+            variable_definition->variable_value = ast_share_value(value);
             return value;
         }
     }
@@ -586,6 +1998,10 @@ AST_T* runtime_visit_variable_modifier(runtime_T* runtime, AST_T* node)
                         ast_variable_definition->variable_value->int_value = (int) ast_variable_definition->variable_value->float_value;
                         return ast_variable_definition->variable_value;
                     }
+                    else if (ast_variable_definition->variable_type->type_value->type == DATA_TYPE_STRING && ast_variable_definition->variable_value->type == AST_STRING)
+                    {
+                        return string_variable_append(ast_variable_definition, value);
+                    }
                 } break;
                 case TOKEN_MINUS_EQUALS: {
                     if (ast_variable_definition->variable_type->type_value->type == DATA_TYPE_INT)
@@ -670,8 +2086,7 @@ AST_T* runtime_function_lookup(runtime_T* runtime, holyc_scope_T* scope, AST_T*
 
         AST_T* ret = runtime_visit(runtime, (AST_T*) function_definition->fptr(runtime, (AST_T*) function_definition, visited_fptr_args));
 
-        free(visited_fptr_args->items);
-        free(visited_fptr_args);
+        dynamic_list_free(visited_fptr_args);
 
         return ret;
     }
@@ -702,8 +2117,7 @@ AST_T* runtime_function_lookup(runtime_T* runtime, holyc_scope_T* scope, AST_T*
         if (data_type == DATA_TYPE_STRING)
         {
             final_result->type = AST_STRING;
-            final_result->string_value = calloc(1, sizeof(char));
-            final_result->string_value[0] = '\0';
+            ast_string_set(final_result, init_holyc_string((void*)0, 0));
         }
 
         dynamic_list_T* call_arguments = init_dynamic_list(sizeof(struct AST_STRUCT*));
@@ -741,7 +2155,7 @@ AST_T* runtime_function_lookup(runtime_T* runtime, holyc_scope_T* scope, AST_T*
             {
                 case AST_INTEGER: final_result->int_value = result->int_value; break;
                 case AST_FLOAT: final_result->float_value = result->float_value; break;
-                case AST_STRING: final_result->string_value = realloc(final_result->string_value, (strlen(result->string_value) + strlen(final_result->string_value) + 1) * sizeof(char)); strcat(final_result->string_value, result->string_value); break;
+                case AST_STRING: ast_string_set(final_result, holyc_string_append(ast_string_header(final_result), result->string_value, ast_string_length(result))); break;
                 default: /* silence */; break;
             }
 
@@ -818,12 +2232,41 @@ AST_T* runtime_visit_enum(runtime_T* runtime, AST_T* node)
 
 AST_T* runtime_visit_list(runtime_T* runtime, AST_T* node)
 {
+    // a list is visited for the first time, store its items unboxed if possible.
+    if (node->function_definitions == (void*)0)
+        ast_list_pack(node);
+
     // attach list methods to the visited list to be able to use them later.
     node->function_definitions = runtime->list_methods;
 
     return node;
 }
 
+AST_T* runtime_visit_map(runtime_T* runtime, AST_T* node)
+{
+    if (node->object_value)
+        return node;
+
+    // a literal builds a new map every time it is visited, the parsed node is left as is.
+    AST_T* ast = init_map_value(runtime);
+    holyc_map_T* map = (holyc_map_T*) ast->object_value;
+
+    for (size_t i = 0; i + 1 < node->list_children->size; i += 2)
+    {
+        AST_T* key = runtime_visit(runtime, (AST_T*) node->list_children->items[i]);
+        AST_T* value = runtime_visit(runtime, (AST_T*) node->list_children->items[i + 1]);
+
+        holyc_map_entry_T* entry = holyc_map_get(map, key);
+
+        if (entry)
+            entry->value = ast_copy_value(value);
+        else
+            holyc_map_set(map, ast_copy_value(key), ast_copy_value(value));
+    }
+
+    return ast;
+}
+
 AST_T* runtime_visit_boolean(runtime_T* runtime, AST_T* node)
 {
     return node;
@@ -897,7 +2340,7 @@ AST_T* runtime_visit_attribute_access(runtime_T* runtime, AST_T* node)
 
     AST_T* left = runtime_visit(runtime, node->binop_left);
 
-    if (left->type == AST_LIST || left->type == AST_STRING)
+    if (left->type == AST_LIST || left->type == AST_STRING || left->type == AST_DEQUE || left->type == AST_MAP || left->type == AST_SET || left->type == AST_BITSET || left->type == AST_HEAP || left->type == AST_BUILDER)
     {
         if (node->binop_right->type == AST_VARIABLE)
         {
@@ -907,12 +2350,37 @@ AST_T* runtime_visit_attribute_access(runtime_T* runtime, AST_T* node)
 
                 if (left->type == AST_LIST)
                 {
-                    int_ast->int_value = left->list_children->size;
+                    int_ast->int_value = ast_list_size(left);
                 }
                 else
                 if (left->type == AST_STRING)
                 {
-                    int_ast->int_value = strlen(left->string_value);
+                    int_ast->int_value = ast_string_length(left);
+                }
+                else
+                if (left->type == AST_DEQUE)
+                {
+                    int_ast->int_value = ((holyc_deque_T*) left->object_value)->size;
+                }
+                else
+                if (left->type == AST_MAP || left->type == AST_SET)
+                {
+                    int_ast->int_value = holyc_map_size((holyc_map_T*) left->object_value);
+                }
+                else
+                if (left->type == AST_BITSET)
+                {
+                    int_ast->int_value = ((holyc_bitset_T*) left->object_value)->size;
+                }
+                else
+                if (left->type == AST_HEAP)
+                {
+                    int_ast->int_value = holyc_heap_size((holyc_heap_T*) left->object_value);
+                }
+                else
+                if (left->type == AST_BUILDER)
+                {
+                    int_ast->int_value = ((holyc_string_T*) left->object_value)->length;
                 }
 
                 return int_ast;
@@ -956,11 +2424,17 @@ AST_T* runtime_visit_attribute_access(runtime_T* runtime, AST_T* node)
         {
             char* function_call_name = node->binop_right->function_call_expr->variable_name;
 
-            if (left->function_definitions != (void*)0)
+            // strings are not given their methods when visited, they may end up in a module.
+            dynamic_list_T* methods = left->function_definitions;
+
+            if (methods == (void*)0 && left->type == AST_STRING)
+                methods = runtime->string_methods;
+
+            if (methods != (void*)0)
             {
-                for (int i = 0; i < left->function_definitions->size; i++)
+                for (int i = 0; i < methods->size; i++)
                 {
-                    AST_T* _fdef = left->function_definitions->items[i];
+                    AST_T* _fdef = methods->items[i];
 
                     if (strcmp(_fdef->function_name, function_call_name) == 0)
                     {
@@ -1009,7 +2483,43 @@ AST_T* runtime_visit_list_access(runtime_T* runtime, AST_T* node)
 
     if (left->type == AST_LIST)
     {
-        return left->list_children->items[runtime_visit(runtime, node->list_access_pointer)->int_value];
+        return ast_list_get(left, runtime_visit(runtime, node->list_access_pointer)->int_value);
+    }
+    else
+    if (left->type == AST_DEQUE)
+    {
+        holyc_deque_T* deque = (holyc_deque_T*) left->object_value;
+        int index = runtime_visit(runtime, node->list_access_pointer)->int_value;
+
+        if (index < 0 || index >= deque->size)
+        {
+            printf("Error: [Line %d] Index out of range\n", node->line_n);
+            exit(1);
+        }
+
+        return (AST_T*) holyc_deque_get(deque, index);
+    }
+    else
+    if (left->type == AST_MAP)
+    {
+        return map_entry(left, runtime_visit(runtime, node->list_access_pointer), "get")->value;
+    }
+    else
+    if (left->type == AST_BITSET)
+    {
+        holyc_bitset_T* bitset = (holyc_bitset_T*) left->object_value;
+        int index = runtime_visit(runtime, node->list_access_pointer)->int_value;
+
+        if (index < 0 || index >= bitset->size)
+        {
+            printf("Error: [Line %d] Index out of range\n", node->line_n);
+            exit(1);
+        }
+
+        AST_T* ast_bool = init_ast(AST_BOOLEAN);
+        ast_bool->boolean_value = holyc_bitset_test(bitset, index);
+
+        return ast_bool;
     }
     else
     if (left->type == AST_STRING)
@@ -1084,7 +2594,7 @@ AST_T* runtime_visit_binop(runtime_T* runtime, AST_T* node)
                             char* arg_name = ast_fdef_arg->variable_name;
 
                             AST_T* new_variable_def = init_ast(AST_VARIABLE_DEFINITION);
-                            new_variable_def->variable_value = runtime_visit(runtime, ast_arg);
+                            new_variable_def->variable_value = ast_share_value(runtime_visit(runtime, ast_arg));
                             new_variable_def->variable_name = arg_name;
 
                             dynamic_list_append(get_scope(runtime, child->function_definition_body)->variable_definitions, new_variable_def);
@@ -1142,51 +2652,28 @@ AST_T* runtime_visit_binop(runtime_T* runtime, AST_T* node)
             }
             if (left->type == AST_STRING && right->type == AST_STRING)
             {
-                char* new_str = calloc(strlen(left->string_value) + strlen(right->string_value) + 1, sizeof(char));
-                strcat(new_str, left->string_value);
-                strcat(new_str, right->string_value);
                 return_value = init_ast(AST_STRING);
-                return_value->string_value = new_str;
+                ast_string_set(return_value, concat_strings(left->string_value, ast_string_length(left), right->string_value, ast_string_length(right)));
 
                 return return_value;
             }
-            if (left->type == AST_STRING && right->type == AST_INTEGER)
+            if (left->type == AST_STRING && (right->type == AST_INTEGER || right->type == AST_FLOAT))
             {
-                const char* int_str_template = "%d";
-                size_t int_padding = sizeof(char) * 4;
-                char* int_str = calloc(strlen(int_str_template + 1 + int_padding), sizeof(char));
-                sprintf(
-                    int_str,
-                    int_str_template,
-                    data_type_has_modifier(right->type_value, DATA_TYPE_MODIFIER_LONG) ? right->long_int_value : right->int_value
-                );
+                char number[HOLYC_FORMAT_BUFFER_SIZE];
+                size_t number_length = format_number(right, number);
 
-                char* new_str = calloc(strlen(left->string_value) + strlen(int_str) + 1, sizeof(char));
-                strcat(new_str, left->string_value);
-                strcat(new_str, int_str);
-                free(int_str);
                 return_value = init_ast(AST_STRING);
-                return_value->string_value = new_str;
+                ast_string_set(return_value, concat_strings(left->string_value, ast_string_length(left), number, number_length));
 
                 return return_value;
             }
-            if (left->type == AST_INTEGER && right->type == AST_STRING)
+            if ((left->type == AST_INTEGER || left->type == AST_FLOAT) && right->type == AST_STRING)
             {
-                const char* int_str_template = "%d";
-                size_t int_padding = sizeof(char) * 4;
-                char* int_str = calloc(strlen(int_str_template + 1 + int_padding), sizeof(char));
-                sprintf(
-                    int_str,
-                    int_str_template,
-                    data_type_has_modifier(left->type_value, DATA_TYPE_MODIFIER_LONG) ? left->long_int_value : left->int_value
-                );
+                char number[HOLYC_FORMAT_BUFFER_SIZE];
+                size_t number_length = format_number(left, number);
 
-                char* new_str = calloc(strlen(right->string_value) + strlen(int_str) + 1, sizeof(char));
-                strcat(new_str, int_str);
-                strcat(new_str, right->string_value);
-                free(int_str);
                 return_value = init_ast(AST_STRING);
-                return_value->string_value = new_str;
+                ast_string_set(return_value, concat_strings(number, number_length, right->string_value, ast_string_length(right)));
 
                 return return_value;
             }
@@ -1515,7 +3002,7 @@ AST_T* runtime_visit_binop(runtime_T* runtime, AST_T* node)
             if (left->type == AST_STRING && right->type == AST_STRING)
             {
                 return_value = init_ast(AST_BOOLEAN);
-                return_value->boolean_value = (strcmp(left->string_value, right->string_value) == 0);
+                return_value->boolean_value = ast_string_equals(left, right);
 
                 return return_value;
             }
@@ -1757,15 +3244,10 @@ AST_T* runtime_visit_iterate(runtime_T* runtime, AST_T* node)
     char* iterable_varname = ((AST_T*)fdef->function_definition_arguments->items[0])->variable_name;
     int x = 0;
 
-    // Clear all existing arguments to prepare for the new definitions
-    for (int z = fdef_body_scope->variable_definitions->size-1; z > 0; z--)
-    {
-        dynamic_list_remove(
-            fdef_body_scope->variable_definitions,
-            fdef_body_scope->variable_definitions->items[z],
-            _ast_free
-        );
-    }
+    // Clear all existing arguments to prepare for the new definitions, the
+    // body scope is part of the parsed tree, which is run again by includes,
+    // -n and servers.
+    holyc_scope_clear_variable_definitions(fdef_body_scope);
 
     AST_T* index_var = (void*)0;
 
@@ -1788,7 +3270,9 @@ AST_T* runtime_visit_iterate(runtime_T* runtime, AST_T* node)
 
         dynamic_list_append(fdef_body_scope->variable_definitions, new_variable_def);
 
-        for (;x < strlen(ast_iterable->string_value); x++)
+        size_t length = ast_string_length(ast_iterable);
+
+        for (;x < length; x++)
         {
             new_variable_def->variable_value->char_value = ast_iterable->string_value[x];
 
@@ -1802,14 +3286,108 @@ AST_T* runtime_visit_iterate(runtime_T* runtime, AST_T* node)
     if (ast_iterable->type == AST_LIST)
     {
         AST_T* new_variable_def = init_ast(AST_VARIABLE_DEFINITION);
-        new_variable_def->variable_value = runtime_visit(runtime, (AST_T*)ast_iterable->list_children->items[x]);
+        new_variable_def->variable_value = ast_list_size(ast_iterable) ? runtime_visit(runtime, ast_list_get(ast_iterable, x)) : (void*)0;
+        new_variable_def->variable_name = iterable_varname;
+
+        dynamic_list_append(fdef_body_scope->variable_definitions, new_variable_def);
+
+        for (;x < ast_list_size(ast_iterable); x++)
+        {
+            // every item of a typed list gets its own box, since the body may keep it.
+            if (ast_iterable->typed_list)
+                new_variable_def->variable_value = holyc_typed_list_box(ast_iterable->typed_list, x);
+            else
+                new_variable_def->variable_value = runtime_visit(runtime, (AST_T*)ast_iterable->list_children->items[x]);
+
+            if (index_var)
+                index_var->variable_value->int_value = x;
+
+            runtime_visit(runtime, fdef->function_definition_body);
+        }
+    }
+    else
+    if (ast_iterable->type == AST_DEQUE)
+    {
+        holyc_deque_T* deque = (holyc_deque_T*) ast_iterable->object_value;
+
+        AST_T* new_variable_def = init_ast(AST_VARIABLE_DEFINITION);
+        new_variable_def->variable_name = iterable_varname;
+
+        dynamic_list_append(fdef_body_scope->variable_definitions, new_variable_def);
+
+        // from front to back, the size is checked again after every item.
+        for (;x < deque->size; x++)
+        {
+            new_variable_def->variable_value = (AST_T*) holyc_deque_get(deque, x);
+
+            if (index_var)
+                index_var->variable_value->int_value = x;
+
+            runtime_visit(runtime, fdef->function_definition_body);
+        }
+    }
+    else
+    if (ast_iterable->type == AST_MAP || ast_iterable->type == AST_SET)
+    {
+        // iterates over a copy of the keys, so the body may modify the map.
+        AST_T* keys = map_items_list(runtime, ast_iterable, 0);
+
+        AST_T* new_variable_def = init_ast(AST_VARIABLE_DEFINITION);
+        new_variable_def->variable_name = iterable_varname;
+
+        dynamic_list_append(fdef_body_scope->variable_definitions, new_variable_def);
+
+        for (;x < ast_list_size(keys); x++)
+        {
+            new_variable_def->variable_value = ast_list_get(keys, x);
+
+            if (index_var)
+                index_var->variable_value->int_value = x;
+
+            runtime_visit(runtime, fdef->function_definition_body);
+        }
+    }
+    else
+    if (ast_iterable->type == AST_BITSET)
+    {
+        holyc_bitset_T* bitset = (holyc_bitset_T*) ast_iterable->object_value;
+
+        AST_T* new_variable_def = init_ast(AST_VARIABLE_DEFINITION);
+        new_variable_def->variable_name = iterable_varname;
+
+        dynamic_list_append(fdef_body_scope->variable_definitions, new_variable_def);
+
+        // goes over the indices of the set bits, skipping empty words.
+        for (size_t bit = holyc_bitset_next(bitset, 0); bit < bitset->size; bit = holyc_bitset_next(bitset, bit + 1), x++)
+        {
+            new_variable_def->variable_value = init_ast(AST_INTEGER);
+            new_variable_def->variable_value->int_value = bit;
+
+            if (index_var)
+                index_var->variable_value->int_value = x;
+
+            runtime_visit(runtime, fdef->function_definition_body);
+        }
+    }
+    else
+    if (ast_iterable->type == AST_LINE_READER)
+    {
+        holyc_line_reader_T* reader = (holyc_line_reader_T*) ast_iterable->object_value;
+
+        AST_T* new_variable_def = init_ast(AST_VARIABLE_DEFINITION);
         new_variable_def->variable_name = iterable_varname;
 
         dynamic_list_append(fdef_body_scope->variable_definitions, new_variable_def);
 
-        for (;x < ast_iterable->list_children->size; x++)
+        AST_T* line_value = (void*)0;
+        const char* line;
+        size_t length;
+
+        // lines are read as they are iterated, the file is never loaded whole.
+        for (; (line = holyc_line_reader_next(reader, &length)) != (void*)0; x++)
         {
-            new_variable_def->variable_value = runtime_visit(runtime, (AST_T*)ast_iterable->list_children->items[x]);
+            line_value = line_string(line_value, line, length);
+            new_variable_def->variable_value = line_value;
 
             if (index_var)
                 index_var->variable_value->int_value = x;
@@ -1885,16 +3463,7 @@ void runtime_expect_args(dynamic_list_T* in_args, int argc, int args[])
 void holyc_runtime_buffer_stdout(runtime_T* runtime, const char* buffer)
 {
     if (runtime->stdout_buffer == (void*)0)
-    {
-        runtime->stdout_buffer = calloc(strlen(buffer) + 1, sizeof(char));
-        strcpy(runtime->stdout_buffer, buffer);
-    }
-    else
-    {
-        runtime->stdout_buffer = realloc(
-            runtime->stdout_buffer,
-            (strlen(runtime->stdout_buffer) + strlen(buffer) + 1) * sizeof(char)
-        );
-        strcat(runtime->stdout_buffer, buffer);
-    }
+        runtime->stdout_buffer = init_holyc_string((void*)0, 0);
+
+    runtime->stdout_buffer = holyc_string_append(runtime->stdout_buffer, buffer, strlen(buffer));
 }
@@ -31,8 +31,7 @@ void holyc_scope_free(holyc_scope_T* holyc_scope)
             free(vardef);
         }
 
-        free(holyc_scope->variable_definitions->items);
-        free(holyc_scope->variable_definitions);
+        dynamic_list_free(holyc_scope->variable_definitions);
         holyc_scope->variable_definitions = (void*)0;
     }
 
@@ -69,8 +68,7 @@ void holyc_scope_free(holyc_scope_T* holyc_scope)
                     free(vardef);
                 }
 
-                free(fdef->function_definition_arguments->items);
-                free(fdef->function_definition_arguments);
+                dynamic_list_free(fdef->function_definition_arguments);
                 fdef->function_definition_arguments = (void*) 0; 
             }
 
@@ -93,16 +91,14 @@ void holyc_scope_free(holyc_scope_T* holyc_scope)
                         ast_free((AST_T*)fdef->composition_children->items[i]);
                 }
 
-                free(fdef->composition_children->items);
-                free(fdef->composition_children);
+                dynamic_list_free(fdef->composition_children);
                 fdef->composition_children = (void*) 0;
             }
 
             free(fdef);
         } 
 
-        free(holyc_scope->function_definitions->items);
-        free(holyc_scope->function_definitions);
+        dynamic_list_free(holyc_scope->function_definitions);
         holyc_scope->function_definitions = (void*) 0;
     }
 
@@ -0,0 +1,471 @@
+#define _POSIX_C_SOURCE 200809L
+#include "include/holyc_server.h"
+#include "include/holyc_include_cache.h"
+#include "include/holyc_output.h"
+#include "include/holyc_writer.h"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#include <stdio.h>
+#include <unistd.h>
+
+
+static volatile sig_atomic_t stopping = 0;
+
+/* the client of the request that is running, -1 between requests */
+static int request_client = -1;
+
+static void stop_handler(int sig)
+{
+    stopping = 1;
+}
+
+static void fill_address(struct sockaddr_un* address, const char* socket_path)
+{
+    if (strlen(socket_path) >= sizeof(address->sun_path))
+    {
+        printf("Error: The socket path `%s` is too long\n", socket_path);
+        exit(1);
+    }
+
+    memset(address, 0, sizeof(struct sockaddr_un));
+    address->sun_family = AF_UNIX;
+    strcpy(address->sun_path, socket_path);
+}
+
+/**
+ * Creates the listening socket, a socket left behind by a server that is
+ * no longer running is replaced.
+ */
+static int open_socket(const char* socket_path)
+{
+    struct sockaddr_un address;
+    fill_address(&address, socket_path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (fd >= 0)
+        unlink(socket_path);
+
+    if (fd < 0 || bind(fd, (struct sockaddr*) &address, sizeof(address)) != 0 || listen(fd, 128) != 0)
+    {
+        printf("Error: Could not listen on `%s`: %s\n", socket_path, strerror(errno));
+        exit(1);
+    }
+
+    return fd;
+}
+
+static unsigned int write_all(int fd, const char* data, size_t size)
+{
+    while (size > 0)
+    {
+        ssize_t written = write(fd, data, size);
+
+        if (written < 0 && errno == EINTR)
+            continue;
+
+        if (written <= 0)
+            return 0;
+
+        data += written;
+        size -= (size_t) written;
+    }
+
+    return 1;
+}
+
+static void send_status(int client, unsigned char status)
+{
+    char trailer[HOLYC_SERVER_STATUS_MARK_SIZE + 1];
+    memcpy(trailer, HOLYC_SERVER_STATUS_MARK, HOLYC_SERVER_STATUS_MARK_SIZE);
+    trailer[HOLYC_SERVER_STATUS_MARK_SIZE] = (char) status;
+
+    write_all(client, trailer, sizeof(trailer));
+}
+
+/**
+ * Registered with atexit in processes that run requests. A script that
+ * fails exits the process, its client is told so after the output the
+ * script has written.
+ */
+static void exit_during_request(void)
+{
+    if (request_client < 0)
+        return;
+
+    fflush(stdout);
+    holyc_writer_flush_all();
+    send_status(request_client, 1);
+}
+
+/**
+ * Reads a request into `buffer` and points `fields` at its NUL terminated
+ * fields.
+ *
+ * @return int the number of fields, 0 for a malformed request
+ */
+static int read_request(int fd, char* buffer, char** fields, int fields_size)
+{
+    size_t size = 0;
+
+    for (;;)
+    {
+        ssize_t count = read(fd, &buffer[size], HOLYC_SERVER_REQUEST_SIZE - size);
+
+        if (count < 0 && errno == EINTR)
+            continue;
+
+        if (count < 0)
+            return 0;
+
+        if (count == 0)
+            break;
+
+        size += (size_t) count;
+
+        if (size == HOLYC_SERVER_REQUEST_SIZE)
+            return 0;
+    }
+
+    if (size == 0 || buffer[size - 1] != '\0')
+        return 0;
+
+    int count = 0;
+
+    for (size_t at = 0; at < size && count < fields_size; at += strlen(&buffer[at]) + 1)
+        fields[count++] = &buffer[at];
+
+    // the working directory and the script are required.
+    return count >= 2 ? count : 0;
+}
+
+/**
+ * Runs the script of a request with its output written to `client`,
+ * stdout is restored once the script is done.
+ *
+ * @return unsigned int 1 if the script ran, the process exits if it fails
+ */
+static unsigned int run_request(runtime_T* runtime, int client, char** fields, int count)
+{
+    if (chdir(fields[0]) != 0)
+    {
+        const char* message = "Error: Could not change to the working directory of the client\n";
+        write_all(client, message, strlen(message));
+        return 0;
+    }
+
+    holyc_output_flush(runtime->output);
+    int saved_stdout = dup(STDOUT_FILENO);
+    dup2(client, STDOUT_FILENO);
+
+    request_client = client;
+
+    AST_T* node = holyc_include_cache_get(runtime->include_cache, fields[1]);
+
+    runtime_set_args(runtime, count - 1, &fields[1]);
+    runtime_run_script(runtime, node);
+
+    // writers of stdout have to be done with it before it is restored.
+    holyc_output_flush(runtime->output);
+    holyc_writer_flush_all();
+
+    request_client = -1;
+
+    dup2(saved_stdout, STDOUT_FILENO);
+    close(saved_stdout);
+
+    return 1;
+}
+
+static void handle_client(runtime_T* runtime, int client, char* buffer)
+{
+    char* fields[HOLYC_SERVER_MAX_FIELDS];
+    int count = read_request(client, buffer, fields, HOLYC_SERVER_MAX_FIELDS);
+
+    if (count)
+    {
+        send_status(client, run_request(runtime, client, fields, count) ? 0 : 1);
+    }
+    else
+    {
+        const char* message = "Error: Malformed request\n";
+        write_all(client, message, strlen(message));
+        send_status(client, 1);
+    }
+}
+
+static void serve_requests(runtime_T* runtime, int listen_fd)
+{
+    char* buffer = malloc(HOLYC_SERVER_REQUEST_SIZE);
+
+    for (;;)
+    {
+        int client = accept(listen_fd, (void*)0, (void*)0);
+
+        if (client < 0)
+            continue;
+
+        handle_client(runtime, client, buffer);
+        close(client);
+    }
+}
+
+/**
+ * Forks a process that starts out with a copy of the runtime.
+ *
+ * @return pid_t 0 in the child
+ */
+static pid_t fork_runtime(runtime_T* runtime)
+{
+    holyc_output_flush(runtime->output);
+    holyc_include_cache_prepare_fork(runtime->include_cache);
+
+    pid_t pid = fork();
+
+    if (pid == 0)
+    {
+        holyc_include_cache_forked(runtime->include_cache);
+        atexit(exit_during_request);
+
+        signal(SIGINT, SIG_DFL);
+        signal(SIGTERM, SIG_DFL);
+        signal(SIGCHLD, SIG_DFL);
+    }
+
+    return pid;
+}
+
+static pid_t start_worker(runtime_T* runtime, int listen_fd)
+{
+    pid_t pid = fork_runtime(runtime);
+
+    if (pid == 0)
+    {
+        serve_requests(runtime, listen_fd);
+        exit(0);
+    }
+
+    return pid;
+}
+
+/**
+ * Prepares the server process, stdin is /dev/null since scripts run by a
+ * server do not read the terminal, and SIGINT and SIGTERM stop the server.
+ */
+static void init_server_process(void)
+{
+    int null_fd = open("/dev/null", O_RDONLY);
+
+    if (null_fd >= 0)
+    {
+        dup2(null_fd, STDIN_FILENO);
+        close(null_fd);
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = stop_handler;
+    sigemptyset(&action.sa_mask);
+
+    // not restarted, so that blocking calls return when the server is stopped.
+    sigaction(SIGINT, &action, (void*)0);
+    sigaction(SIGTERM, &action, (void*)0);
+}
+
+/**
+ * Listens on `socket_path` until the server is interrupted or terminated.
+ *
+ * @param runtime_T* runtime an initialized runtime, copied into every worker
+ * @param const char* socket_path
+ * @param size_t workers 0 for one worker per core
+ *
+ * @return int the exit status
+ */
+int holyc_server_serve(runtime_T* runtime, const char* socket_path, size_t workers)
+{
+    if (workers == 0)
+        workers = holyc_thread_pool_default_size();
+
+    int listen_fd = open_socket(socket_path);
+    init_server_process();
+
+    pid_t* pids = calloc(workers, sizeof(pid_t));
+
+    for (size_t i = 0; i < workers; i++)
+        pids[i] = start_worker(runtime, listen_fd);
+
+    while (!stopping)
+    {
+        pid_t pid = waitpid(-1, (void*)0, 0);
+
+        if (pid < 0)
+            continue;
+
+        for (size_t i = 0; i < workers && !stopping; i++)
+        {
+            if (pids[i] == pid)
+                pids[i] = start_worker(runtime, listen_fd);
+        }
+    }
+
+    for (size_t i = 0; i < workers; i++)
+    {
+        if (pids[i] > 0)
+            kill(pids[i], SIGTERM);
+    }
+
+    while (waitpid(-1, (void*)0, 0) > 0 || errno == EINTR)
+        continue;
+
+    close(listen_fd);
+    unlink(socket_path);
+    free(pids);
+
+    return 0;
+}
+
+/**
+ * Listens on `socket_path` and forks a child for every request, until the
+ * server is interrupted or terminated. The prelude is run and the scripts
+ * are parsed before the first request, so children start with the
+ * definitions of the prelude and the parsed scripts in memory.
+ *
+ * @param runtime_T* runtime an initialized runtime
+ * @param const char* socket_path
+ * @param const char* prelude a script to run first, or NULL
+ * @param int scripts_size
+ * @param char** scripts the scripts to parse ahead of time
+ *
+ * @return int the exit status
+ */
+int holyc_server_fork_serve(runtime_T* runtime, const char* socket_path, const char* prelude, int scripts_size, char** scripts)
+{
+    if (prelude)
+        runtime_visit(runtime, holyc_include_cache_get(runtime->include_cache, prelude));
+
+    for (int i = 0; i < scripts_size; i++)
+        holyc_include_cache_get(runtime->include_cache, scripts[i]);
+
+    int listen_fd = open_socket(socket_path);
+    init_server_process();
+
+    // children are reaped by the system.
+    signal(SIGCHLD, SIG_IGN);
+
+    char* buffer = malloc(HOLYC_SERVER_REQUEST_SIZE);
+
+    while (!stopping)
+    {
+        int client = accept(listen_fd, (void*)0, (void*)0);
+
+        if (client < 0)
+            continue;
+
+        pid_t pid = fork_runtime(runtime);
+
+        if (pid == 0)
+        {
+            close(listen_fd);
+            handle_client(runtime, client, buffer);
+
+            exit(0);
+        }
+
+        if (pid < 0)
+        {
+            const char* message = "Error: Could not fork\n";
+            write_all(client, message, strlen(message));
+            send_status(client, 1);
+        }
+
+        close(client);
+    }
+
+    close(listen_fd);
+    unlink(socket_path);
+    free(buffer);
+
+    return 0;
+}
+
+/**
+ * Sends the script `argv[0]` and its arguments to a server and copies
+ * the output of the script to stdout. The last bytes read are held back
+ * until the connection is closed, since they may be the status trailer.
+ *
+ * @param const char* socket_path
+ * @param int argc
+ * @param char** argv
+ *
+ * @return int the exit status of the script, 1 if the server could not be
+ * reached or closed the connection before the script was done
+ */
+int holyc_server_connect(const char* socket_path, int argc, char** argv)
+{
+    struct sockaddr_un address;
+    fill_address(&address, socket_path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (fd < 0 || connect(fd, (struct sockaddr*) &address, sizeof(address)) != 0)
+    {
+        printf("Error: Could not connect to `%s`: %s\n", socket_path, strerror(errno));
+        return 1;
+    }
+
+    char cwd[4096];
+
+    if (getcwd(cwd, sizeof(cwd)) == (void*)0)
+    {
+        printf("Error: Could not get the working directory\n");
+        return 1;
+    }
+
+    unsigned int sent = write_all(fd, cwd, strlen(cwd) + 1);
+
+    for (int i = 0; i < argc && sent; i++)
+        sent = write_all(fd, argv[i], strlen(argv[i]) + 1);
+
+    shutdown(fd, SHUT_WR);
+
+    const size_t trailer_size = HOLYC_SERVER_STATUS_MARK_SIZE + 1;
+
+    char buffer[64 * 1024];
+    size_t held = 0;
+    ssize_t count;
+
+    while ((count = read(fd, &buffer[held], sizeof(buffer) - held)) != 0)
+    {
+        if (count < 0 && errno == EINTR)
+            continue;
+
+        if (count < 0)
+            break;
+
+        held += (size_t) count;
+
+        if (held <= trailer_size)
+            continue;
+
+        if (!write_all(STDOUT_FILENO, buffer, held - trailer_size))
+            break;
+
+        memmove(buffer, &buffer[held - trailer_size], trailer_size);
+        held = trailer_size;
+    }
+
+    close(fd);
+
+    if (held == trailer_size && memcmp(buffer, HOLYC_SERVER_STATUS_MARK, HOLYC_SERVER_STATUS_MARK_SIZE) == 0)
+        return sent ? (unsigned char) buffer[HOLYC_SERVER_STATUS_MARK_SIZE] : 1;
+
+    write_all(STDOUT_FILENO, buffer, held);
+    printf("Error: The server closed the connection before the script was done\n");
+
+    return 1;
+}
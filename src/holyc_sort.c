@@ -0,0 +1,505 @@
+#include "include/holyc_sort.h"
+#include "include/holyc_thread_pool.h"
+#include <string.h>
+#include <limits.h>
+#include <stdio.h>
+
+/* runs shorter than this are insertion sorted */
+#define INSERTION_SORT_MAX 16
+
+
+/* ==== radix sort ==== */
+
+/**
+ * Maps keys to unsigned ints that sort in the same order.
+ * Signed ints only need their sign bit flipped, doubles also need all of
+ * their other bits flipped when they are negative.
+ */
+static uint64_t i64_to_key(int64_t x) { return (uint64_t) x ^ ((uint64_t) 1 << 63); }
+static int64_t key_to_i64(uint64_t k) { return (int64_t) (k ^ ((uint64_t) 1 << 63)); }
+
+static uint64_t f64_to_key(double x)
+{
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+
+    return bits >> 63 ? ~bits : bits ^ ((uint64_t) 1 << 63);
+}
+
+static double key_to_f64(uint64_t k)
+{
+    uint64_t bits = k >> 63 ? k ^ ((uint64_t) 1 << 63) : ~k;
+    double x;
+    memcpy(&x, &bits, sizeof(x));
+
+    return x;
+}
+
+static void insertion_sort_keys(uint64_t* x, size_t n)
+{
+    for (size_t i = 1; i < n; i++)
+    {
+        uint64_t key = x[i];
+        size_t j = i;
+
+        for (; j > 0 && x[j - 1] > key; j--)
+            x[j] = x[j - 1];
+
+        x[j] = key;
+    }
+}
+
+/**
+ * LSD radix sort of 8 bit digits, the counts of all digits are taken in one
+ * pass and digits that are the same for every key are skipped.
+ */
+static void radix_sort_keys(uint64_t* x, size_t n)
+{
+    if (n <= INSERTION_SORT_MAX * 4)
+    {
+        insertion_sort_keys(x, n);
+        return;
+    }
+
+    size_t (*counts)[256] = calloc(8, sizeof(*counts));
+    uint64_t* tmp = malloc(n * sizeof(uint64_t));
+
+    if (counts == (void*)0 || tmp == (void*)0)
+    {
+        printf("Error: Out of memory\n");
+        exit(1);
+    }
+
+    for (size_t i = 0; i < n; i++)
+        for (int d = 0; d < 8; d++)
+            counts[d][(x[i] >> (d * 8)) & 0xFF] += 1;
+
+    uint64_t* src = x;
+    uint64_t* dst = tmp;
+
+    for (int d = 0; d < 8; d++)
+    {
+        if (counts[d][(x[0] >> (d * 8)) & 0xFF] == n)
+            continue;
+
+        size_t offset = 0;
+
+        for (int b = 0; b < 256; b++)
+        {
+            size_t count = counts[d][b];
+            counts[d][b] = offset;
+            offset += count;
+        }
+
+        for (size_t i = 0; i < n; i++)
+            dst[counts[d][(src[i] >> (d * 8)) & 0xFF]++] = src[i];
+
+        uint64_t* swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    if (src != x)
+        memcpy(x, src, n * sizeof(uint64_t));
+
+    free(tmp);
+    free(counts);
+}
+
+/**
+ * Sorts ints in place, smallest first.
+ *
+ * @param int64_t* x
+ * @param size_t n
+ */
+void holyc_sort_i64(int64_t* x, size_t n)
+{
+    uint64_t* keys = (uint64_t*) x;
+
+    for (size_t i = 0; i < n; i++)
+        keys[i] = i64_to_key(x[i]);
+
+    radix_sort_keys(keys, n);
+
+    for (size_t i = 0; i < n; i++)
+        x[i] = key_to_i64(keys[i]);
+}
+
+/**
+ * Sorts floats in place, smallest first.
+ *
+ * @param double* x
+ * @param size_t n
+ */
+void holyc_sort_f64(double* x, size_t n)
+{
+    uint64_t* keys = (uint64_t*) x;
+
+    for (size_t i = 0; i < n; i++)
+        keys[i] = f64_to_key(x[i]);
+
+    radix_sort_keys(keys, n);
+
+    for (size_t i = 0; i < n; i++)
+        x[i] = key_to_f64(keys[i]);
+}
+
+/**
+ * Sorts chars in place by counting them.
+ *
+ * @param char* x
+ * @param size_t n
+ */
+void holyc_sort_char(char* x, size_t n)
+{
+    size_t counts[256] = { 0 };
+
+    for (size_t i = 0; i < n; i++)
+        counts[(unsigned char) x[i]] += 1;
+
+    size_t i = 0;
+
+    for (int c = CHAR_MIN; c <= CHAR_MAX; c++)
+        for (size_t k = counts[(unsigned char) c]; k > 0; k--)
+            x[i++] = (char) c;
+}
+
+
+/* ==== introsort ==== */
+
+static double number_of(AST_T* ast)
+{
+    if (ast->type == AST_FLOAT)
+        return ast->float_value;
+
+    return ast_int_value(ast);
+}
+
+/**
+ * Orders numbers by value and strings by strcmp, the order used when no
+ * comparator is given.
+ *
+ * @param void* context unused
+ * @param AST_T* a
+ * @param AST_T* b
+ *
+ * @return unsigned int
+ */
+unsigned int holyc_sort_less_by_value(void* context, AST_T* a, AST_T* b)
+{
+    unsigned int a_number = a->type == AST_INTEGER || a->type == AST_FLOAT;
+    unsigned int b_number = b->type == AST_INTEGER || b->type == AST_FLOAT;
+
+    if (a_number && b_number)
+        return number_of(a) < number_of(b);
+
+    if (a->type == AST_STRING && b->type == AST_STRING)
+        return strcmp(a->string_value, b->string_value) < 0;
+
+    if (a->type == AST_CHAR && b->type == AST_CHAR)
+        return a->char_value < b->char_value;
+
+    printf("Error: [Line %d] Items can not be compared without a comparator\n", a->line_n);
+    exit(1);
+}
+
+#define SWAP_NODES(x, i, j) do { AST_T* t = (x)[i]; (x)[i] = (x)[j]; (x)[j] = t; } while (0)
+
+static void insertion_sort_nodes(AST_T** x, size_t n, holyc_sort_less_T less, void* context)
+{
+    for (size_t i = 1; i < n; i++)
+    {
+        AST_T* item = x[i];
+        size_t j = i;
+
+        for (; j > 0 && less(context, item, x[j - 1]); j--)
+            x[j] = x[j - 1];
+
+        x[j] = item;
+    }
+}
+
+static void sift_down_nodes(AST_T** x, size_t n, size_t i, holyc_sort_less_T less, void* context)
+{
+    size_t child;
+
+    while ((child = 2 * i + 1) < n)
+    {
+        if (child + 1 < n && less(context, x[child], x[child + 1]))
+            child += 1;
+
+        if (!less(context, x[i], x[child]))
+            return;
+
+        SWAP_NODES(x, i, child);
+        i = child;
+    }
+}
+
+static void heap_sort_nodes(AST_T** x, size_t n, holyc_sort_less_T less, void* context)
+{
+    for (size_t i = n / 2; i-- > 0;)
+        sift_down_nodes(x, n, i, less, context);
+
+    for (size_t end = n; end-- > 1;)
+    {
+        SWAP_NODES(x, 0, end);
+        sift_down_nodes(x, end, 0, less, context);
+    }
+}
+
+/**
+ * Quicksort with a median of three pivot, falls back to heapsort when the
+ * partitions keep coming out uneven. The scans are bounds checked, so a
+ * comparator that is not consistent gives a wrong order but no crash.
+ */
+static void introsort_nodes(AST_T** x, size_t n, size_t depth, holyc_sort_less_T less, void* context)
+{
+    while (n > INSERTION_SORT_MAX)
+    {
+        if (depth == 0)
+        {
+            heap_sort_nodes(x, n, less, context);
+            return;
+        }
+
+        depth -= 1;
+
+        size_t mid = n / 2;
+
+        if (less(context, x[mid], x[0]))
+            SWAP_NODES(x, 0, mid);
+
+        if (less(context, x[n - 1], x[mid]))
+        {
+            SWAP_NODES(x, mid, n - 1);
+
+            if (less(context, x[mid], x[0]))
+                SWAP_NODES(x, 0, mid);
+        }
+
+        AST_T* pivot = x[mid];
+        size_t i = 0;
+        size_t j = n - 1;
+
+        while (1)
+        {
+            while (i < n - 1 && less(context, x[i], pivot))
+                i++;
+
+            while (j > 0 && less(context, pivot, x[j]))
+                j--;
+
+            if (i >= j)
+                break;
+
+            SWAP_NODES(x, i, j);
+            i++;
+            j--;
+        }
+
+        size_t split = j + 1;
+
+        // recurse into the smaller side to keep the stack logarithmic.
+        if (split < n - split)
+        {
+            introsort_nodes(x, split, depth, less, context);
+            x += split;
+            n -= split;
+        }
+        else
+        {
+            introsort_nodes(x + split, n - split, depth, less, context);
+            n = split;
+        }
+    }
+
+    insertion_sort_nodes(x, n, less, context);
+}
+
+static void sort_nodes_sequential(AST_T** items, size_t n, holyc_sort_less_T less, void* context)
+{
+    size_t depth = 0;
+
+    for (size_t m = n; m > 1; m >>= 1)
+        depth += 2;
+
+    introsort_nodes(items, n, depth, less, context);
+}
+
+
+/* ==== parallel merge sort ==== */
+
+enum { SORT_I64, SORT_F64, SORT_NODES };
+
+typedef struct SORT_JOB_STRUCT
+{
+    int kind;
+    size_t item_size;
+    char* src;
+    char* dst;
+    size_t start;
+    size_t mid;
+    size_t end;
+    holyc_sort_less_T less;
+    void* context;
+} sort_job_T;
+
+static void sort_run_job(void* arg)
+{
+    sort_job_T* job = (sort_job_T*) arg;
+    void* run = job->src + job->start * job->item_size;
+    size_t n = job->end - job->start;
+
+    switch (job->kind)
+    {
+        case SORT_I64: holyc_sort_i64(run, n); break;
+        case SORT_F64: holyc_sort_f64(run, n); break;
+        default: sort_nodes_sequential(run, n, job->less, job->context); break;
+    }
+}
+
+#define MERGE_RUNS(type, before) \
+{ \
+    type* src = (type*) job->src; \
+    type* dst = (type*) job->dst; \
+    size_t i = job->start, j = job->mid, k = job->start; \
+    while (i < job->mid && j < job->end) \
+        dst[k++] = before(src[j], src[i]) ? src[j++] : src[i++]; \
+    while (i < job->mid) \
+        dst[k++] = src[i++]; \
+    while (j < job->end) \
+        dst[k++] = src[j++]; \
+}
+
+#define LESS_THAN(a, b) ((a) < (b))
+#define LESS_NODES(a, b) job->less(job->context, (a), (b))
+
+/**
+ * Merges the sorted runs [start, mid) and [mid, end) of src into dst,
+ * taking from the left run on ties.
+ */
+static void merge_runs_job(void* arg)
+{
+    sort_job_T* job = (sort_job_T*) arg;
+
+    switch (job->kind)
+    {
+        case SORT_I64: MERGE_RUNS(int64_t, LESS_THAN) break;
+        case SORT_F64: MERGE_RUNS(double, LESS_THAN) break;
+        default: MERGE_RUNS(AST_T*, LESS_NODES) break;
+    }
+}
+
+/**
+ * Sorts one run per thread, then merges pairs of runs until one is left,
+ * each round of merges also runs in parallel.
+ */
+static void sort_parallel(int kind, void* data, size_t item_size, size_t n, holyc_sort_less_T less, void* context)
+{
+    holyc_thread_pool_T* pool = init_holyc_thread_pool(0);
+
+    size_t runs_size = 1;
+
+    while (runs_size * 2 <= pool->threads_size * 2 && n / (runs_size * 2) >= HOLYC_SORT_PARALLEL_THRESHOLD / 8)
+        runs_size *= 2;
+
+    size_t* bounds = calloc(runs_size + 1, sizeof(size_t));
+    sort_job_T* jobs = calloc(runs_size, sizeof(struct SORT_JOB_STRUCT));
+    char* tmp = malloc(n * item_size);
+
+    if (bounds == (void*)0 || jobs == (void*)0 || tmp == (void*)0)
+    {
+        printf("Error: Out of memory\n");
+        exit(1);
+    }
+
+    for (size_t r = 0; r <= runs_size; r++)
+        bounds[r] = n * r / runs_size;
+
+    for (size_t r = 0; r < runs_size; r++)
+    {
+        jobs[r] = (sort_job_T) { kind, item_size, data, tmp, bounds[r], bounds[r], bounds[r + 1], less, context };
+        holyc_thread_pool_submit(pool, sort_run_job, &jobs[r]);
+    }
+
+    holyc_thread_pool_wait(pool);
+
+    char* src = data;
+    char* dst = tmp;
+
+    for (size_t width = 1; width < runs_size; width *= 2)
+    {
+        size_t jobs_size = 0;
+
+        for (size_t r = 0; r < runs_size; r += 2 * width)
+        {
+            jobs[jobs_size] = (sort_job_T) { kind, item_size, src, dst, bounds[r], bounds[r + width], bounds[r + 2 * width], less, context };
+            holyc_thread_pool_submit(pool, merge_runs_job, &jobs[jobs_size]);
+            jobs_size += 1;
+        }
+
+        holyc_thread_pool_wait(pool);
+
+        char* swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    if (src != (char*) data)
+        memcpy(data, src, n * item_size);
+
+    holyc_thread_pool_free(pool);
+    free(tmp);
+    free(jobs);
+    free(bounds);
+}
+
+
+/**
+ * Sorts a typed list in place, ints and floats by radix sort and chars by
+ * counting them.
+ *
+ * @param holyc_typed_list_T* typed_list
+ */
+void holyc_sort_typed_list(holyc_typed_list_T* typed_list)
+{
+    size_t n = typed_list->size;
+    void* data = holyc_typed_list_mutable_data(typed_list);
+
+    switch (typed_list->type)
+    {
+        case HOLYC_TYPED_LIST_INT:
+            if (n >= HOLYC_SORT_PARALLEL_THRESHOLD)
+                sort_parallel(SORT_I64, data, sizeof(int64_t), n, (void*)0, (void*)0);
+            else
+                holyc_sort_i64(data, n);
+        break;
+        case HOLYC_TYPED_LIST_FLOAT:
+            if (n >= HOLYC_SORT_PARALLEL_THRESHOLD)
+                sort_parallel(SORT_F64, data, sizeof(double), n, (void*)0, (void*)0);
+            else
+                holyc_sort_f64(data, n);
+        break;
+        default: holyc_sort_char(data, n); break;
+    }
+}
+
+/**
+ * Sorts nodes in place with introsort, the order of equal items is not kept.
+ * Large lists are sorted in parallel when `less` is
+ * holyc_sort_less_by_value, other comparators may call into the runtime,
+ * which is not thread safe.
+ *
+ * @param AST_T** items
+ * @param size_t n
+ * @param holyc_sort_less_T less
+ * @param void* context passed to `less`
+ */
+void holyc_sort_nodes(AST_T** items, size_t n, holyc_sort_less_T less, void* context)
+{
+    if (less == holyc_sort_less_by_value && n >= HOLYC_SORT_PARALLEL_THRESHOLD)
+        sort_parallel(SORT_NODES, items, sizeof(AST_T*), n, less, context);
+    else
+        sort_nodes_sequential(items, n, less, context);
+}
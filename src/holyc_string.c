@@ -0,0 +1,186 @@
+#define _DEFAULT_SOURCE
+#include "include/holyc_string.h"
+#include "include/string_utils.h"
+#include <string.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+/**
+ * Creates a string of the first `length` chars of `value`, `value` may be
+ * NULL for a string of `length` NUL chars to be filled in.
+ *
+ * @param const char* value
+ * @param size_t length
+ *
+ * @return holyc_string_T*
+ */
+holyc_string_T* init_holyc_string(const char* value, size_t length)
+{
+    holyc_string_T* string = calloc(1, sizeof(struct holyc_STRING_STRUCT) + length + 1);
+
+    if (string == (void*)0)
+    {
+        printf("Error: Out of memory\n");
+        exit(1);
+    }
+
+    string->length = length;
+    string->capacity = length;
+
+    if (value && length)
+        memcpy(string->data, value, length);
+
+    return string;
+}
+
+/**
+ * Makes room for at least `capacity` chars, growing geometrically.
+ * The string may move, so the returned string must be used instead.
+ *
+ * @param holyc_string_T* string
+ * @param size_t capacity
+ *
+ * @return holyc_string_T*
+ */
+holyc_string_T* holyc_string_reserve(holyc_string_T* string, size_t capacity)
+{
+    if (capacity <= string->capacity)
+        return string;
+
+    if (string->mapped)
+    {
+        holyc_string_T* copy = init_holyc_string(string->data, string->length);
+        holyc_string_free(string);
+
+        return holyc_string_reserve(copy, capacity);
+    }
+
+    size_t new_capacity = string->capacity * 2;
+
+    if (new_capacity < capacity)
+        new_capacity = capacity;
+
+    holyc_string_T* new_string = realloc(string, sizeof(struct holyc_STRING_STRUCT) + new_capacity + 1);
+
+    if (new_string == (void*)0)
+    {
+        printf("Error: Out of memory\n");
+        exit(1);
+    }
+
+    new_string->capacity = new_capacity;
+
+    return new_string;
+}
+
+/**
+ * Appends `length` chars of `value`, which may point into the string
+ * itself. The string may move, so the returned string must be used instead.
+ *
+ * @param holyc_string_T* string
+ * @param const char* value
+ * @param size_t length
+ *
+ * @return holyc_string_T*
+ */
+holyc_string_T* holyc_string_append(holyc_string_T* string, const char* value, size_t length)
+{
+    unsigned int inside = value >= string->data && value <= string->data + string->length;
+    size_t offset = inside ? (size_t) (value - string->data) : 0;
+
+    string = holyc_string_reserve(string, string->length + length);
+
+    if (inside)
+        value = string->data + offset;
+
+    memcpy(&string->data[string->length], value, length);
+    string->length += length;
+    string->data[string->length] = '\0';
+    string->hashed = 0;
+
+    return string;
+}
+
+/**
+ * Maps the file of `fd` into memory as a read only string, without
+ * reading it. Pages of the file are only loaded once they are accessed.
+ * The header is placed in an anonymous page right before the file, and
+ * an anonymous page after it makes sure the string is NUL terminated
+ * when the file ends on a page boundary.
+ *
+ * @param int fd
+ *
+ * @return holyc_string_T* NULL if the file can not be mapped
+ */
+holyc_string_T* holyc_string_map_file(int fd)
+{
+    struct stat st;
+
+    if (fstat(fd, &st) != 0)
+        return (void*)0;
+
+    if (st.st_size == 0)
+        return init_holyc_string((void*)0, 0);
+
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    size_t length = (size_t) st.st_size;
+    size_t mapped = page + (length + page - 1) / page * page + page;
+
+    char* base = mmap((void*)0, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (base == MAP_FAILED)
+        return (void*)0;
+
+    if (mmap(base + page, length, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)
+    {
+        munmap(base, mapped);
+        return (void*)0;
+    }
+
+    holyc_string_T* string = (holyc_string_T*) (base + page - sizeof(struct holyc_STRING_STRUCT));
+    string->length = length;
+    string->capacity = length;
+    string->hash = 0;
+    string->hashed = 0;
+    string->unique = 0;
+    string->mapped = mapped;
+
+    return string;
+}
+
+/**
+ * @param holyc_string_T* string
+ *
+ * @return uint32_t the FNV-1a hash of the chars
+ */
+uint32_t holyc_string_hash(holyc_string_T* string)
+{
+    if (!string->hashed)
+    {
+        string->hash = holyc_fnv1a(HOLYC_FNV1A_INIT, string->data, string->length);
+        string->hashed = 1;
+    }
+
+    return string->hash;
+}
+
+/**
+ * Deallocates a string.
+ *
+ * @param holyc_string_T* string
+ */
+void holyc_string_free(holyc_string_T* string)
+{
+    if (string->mapped)
+    {
+        size_t page = (size_t) sysconf(_SC_PAGESIZE);
+        munmap(string->data - page, string->mapped);
+
+        return;
+    }
+
+    free(string);
+}
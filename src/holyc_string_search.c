@@ -0,0 +1,305 @@
+#include "include/holyc_string_search.h"
+#include <string.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+/* ==== short needles ==== */
+
+static size_t find_short(const char* haystack, size_t length, const char* needle, size_t needle_length)
+{
+    size_t i = 0;
+    char first = needle[0];
+    char last = needle[needle_length - 1];
+
+#if defined(__SSE2__)
+    // a position is only compared in full when both its first and last char match.
+    __m128i vfirst = _mm_set1_epi8(first);
+    __m128i vlast = _mm_set1_epi8(last);
+
+    for (; i + needle_length + 15 <= length; i += 16)
+    {
+        __m128i block_first = _mm_loadu_si128((const __m128i*) &haystack[i]);
+        __m128i block_last = _mm_loadu_si128((const __m128i*) &haystack[i + needle_length - 1]);
+        unsigned int mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(block_first, vfirst), _mm_cmpeq_epi8(block_last, vlast)));
+
+        while (mask)
+        {
+            size_t at = i + __builtin_ctz(mask);
+
+            if (memcmp(&haystack[at + 1], &needle[1], needle_length - 2) == 0)
+                return at;
+
+            mask &= mask - 1;
+        }
+    }
+#endif
+
+    while (i + needle_length <= length)
+    {
+        const char* at = memchr(&haystack[i], first, length - needle_length + 1 - i);
+
+        if (at == (void*)0)
+            break;
+
+        i = at - haystack;
+
+        if (haystack[i + needle_length - 1] == last && memcmp(&haystack[i + 1], &needle[1], needle_length - 2) == 0)
+            return i;
+
+        i += 1;
+    }
+
+    return HOLYC_STRING_NOT_FOUND;
+}
+
+
+/* ==== two-way ==== */
+
+/**
+ * Computes the maximal suffix of the needle for the ordering of chars, or
+ * the reversed ordering if `reversed`.
+ */
+static size_t maximal_suffix(const unsigned char* needle, size_t length, unsigned int reversed, size_t* period)
+{
+    size_t ip = (size_t) -1;
+    size_t jp = 0;
+    size_t k = 1;
+    size_t p = 1;
+
+    while (jp + k < length)
+    {
+        unsigned char a = needle[ip + k];
+        unsigned char b = needle[jp + k];
+
+        if (a == b)
+        {
+            if (k == p)
+            {
+                jp += p;
+                k = 1;
+            }
+            else
+            {
+                k += 1;
+            }
+        }
+        else
+        if (reversed ? a < b : a > b)
+        {
+            jp += k;
+            k = 1;
+            p = jp - ip;
+        }
+        else
+        {
+            ip = jp++;
+            k = p = 1;
+        }
+    }
+
+    *period = p;
+
+    return ip;
+}
+
+static void two_way_prepare(holyc_string_searcher_T* searcher)
+{
+    const unsigned char* needle = (const unsigned char*) searcher->needle;
+    size_t length = searcher->length;
+    size_t period, reversed_period;
+
+    // the critical factorization is the later of the two maximal suffixes.
+    size_t critical = maximal_suffix(needle, length, 0, &period);
+    size_t reversed_critical = maximal_suffix(needle, length, 1, &reversed_period);
+
+    if (reversed_critical + 1 > critical + 1)
+    {
+        critical = reversed_critical;
+        period = reversed_period;
+    }
+
+    searcher->critical = critical;
+    searcher->periodic = memcmp(needle, needle + period, critical + 1) == 0;
+
+    if (!searcher->periodic)
+    {
+        size_t right = length - critical - 1;
+        period = (critical > right ? critical : right) + 1;
+    }
+
+    searcher->period = period;
+    searcher->shift = calloc(256, sizeof(size_t));
+
+    for (size_t i = 0; i < length; i++)
+        searcher->shift[needle[i]] = i + 1;
+}
+
+static size_t two_way_find(holyc_string_searcher_T* searcher, const char* haystack, size_t length)
+{
+    const unsigned char* needle = (const unsigned char*) searcher->needle;
+    const unsigned char* h = (const unsigned char*) haystack;
+    size_t l = searcher->length;
+    size_t critical = searcher->critical;
+    size_t memory_reset = searcher->periodic ? l - searcher->period : 0;
+    size_t memory = 0;
+    size_t at = 0;
+
+    while (at + l <= length)
+    {
+        // skip ahead by the last occurence of the last char in the needle.
+        size_t k = l - searcher->shift[h[at + l - 1]];
+
+        if (k)
+        {
+            at += k < memory ? memory : k;
+            memory = 0;
+            continue;
+        }
+
+        // compare the right half, then the left half.
+        for (k = critical + 1 > memory ? critical + 1 : memory; k < l && needle[k] == h[at + k]; k++);
+
+        if (k < l)
+        {
+            at += k - critical;
+            memory = 0;
+            continue;
+        }
+
+        for (k = critical + 1; k > memory && needle[k - 1] == h[at + k - 1]; k--);
+
+        if (k <= memory)
+            return at;
+
+        at += searcher->period;
+        memory = memory_reset;
+    }
+
+    return HOLYC_STRING_NOT_FOUND;
+}
+
+
+/* ==== searcher ==== */
+
+/**
+ * Prepares `needle` for searching, the needle is not copied and has to
+ * outlive the searcher.
+ *
+ * @param const char* needle
+ * @param size_t length
+ *
+ * @return holyc_string_searcher_T*
+ */
+holyc_string_searcher_T* init_holyc_string_searcher(const char* needle, size_t length)
+{
+    holyc_string_searcher_T* searcher = calloc(1, sizeof(struct holyc_STRING_SEARCHER_STRUCT));
+    searcher->needle = needle;
+    searcher->length = length;
+    searcher->shift = (void*)0;
+
+    if (length >= HOLYC_STRING_TWO_WAY_THRESHOLD)
+        two_way_prepare(searcher);
+
+    return searcher;
+}
+
+/**
+ * Returns the index of the first occurence of the needle in `haystack`,
+ * or HOLYC_STRING_NOT_FOUND. An empty needle is found at 0.
+ *
+ * @param holyc_string_searcher_T* searcher
+ * @param const char* haystack
+ * @param size_t length
+ *
+ * @return size_t
+ */
+size_t holyc_string_searcher_find(holyc_string_searcher_T* searcher, const char* haystack, size_t length)
+{
+    if (searcher->length == 0)
+        return 0;
+
+    if (searcher->length > length)
+        return HOLYC_STRING_NOT_FOUND;
+
+    if (searcher->length == 1)
+    {
+        const char* at = memchr(haystack, searcher->needle[0], length);
+        return at ? (size_t) (at - haystack) : HOLYC_STRING_NOT_FOUND;
+    }
+
+    if (searcher->shift)
+        return two_way_find(searcher, haystack, length);
+
+    return find_short(haystack, length, searcher->needle, searcher->length);
+}
+
+/**
+ * Deallocates a searcher, but not its needle.
+ *
+ * @param holyc_string_searcher_T* searcher
+ */
+void holyc_string_searcher_free(holyc_string_searcher_T* searcher)
+{
+    if (searcher->shift)
+        free(searcher->shift);
+
+    free(searcher);
+}
+
+/**
+ * Finds a needle that is only searched for once.
+ *
+ * @param const char* haystack
+ * @param size_t haystack_length
+ * @param const char* needle
+ * @param size_t needle_length
+ *
+ * @return size_t index of the first occurence or HOLYC_STRING_NOT_FOUND
+ */
+size_t holyc_string_find(const char* haystack, size_t haystack_length, const char* needle, size_t needle_length)
+{
+    holyc_string_searcher_T searcher = { needle, needle_length, 0, 0, 0, (void*)0 };
+
+    if (needle_length >= HOLYC_STRING_TWO_WAY_THRESHOLD)
+        two_way_prepare(&searcher);
+
+    size_t index = holyc_string_searcher_find(&searcher, haystack, haystack_length);
+
+    if (searcher.shift)
+        free(searcher.shift);
+
+    return index;
+}
+
+/**
+ * @param const char* haystack
+ * @param size_t length
+ * @param char c
+ *
+ * @return size_t the number of times `c` occurs in `haystack`
+ */
+size_t holyc_string_count_char(const char* haystack, size_t length, char c)
+{
+    size_t i = 0;
+    size_t count = 0;
+
+#if defined(__SSE2__)
+    __m128i vc = _mm_set1_epi8(c);
+
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i*) &haystack[i]);
+        count += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(block, vc)));
+    }
+#endif
+
+    for (; i < length; i++)
+        count += haystack[i] == c;
+
+    return count;
+}
@@ -0,0 +1,156 @@
+#define _POSIX_C_SOURCE 200809L
+#include "include/holyc_thread_pool.h"
+#include <unistd.h>
+#include <stdio.h>
+
+
+static void* holyc_thread_pool_worker(void* p)
+{
+    holyc_thread_pool_T* pool = (holyc_thread_pool_T*) p;
+
+    while (1)
+    {
+        pthread_mutex_lock(&pool->lock);
+
+        while (pool->head == (void*)0 && !pool->stopping)
+            pthread_cond_wait(&pool->job_available, &pool->lock);
+
+        if (pool->head == (void*)0 && pool->stopping)
+        {
+            pthread_mutex_unlock(&pool->lock);
+            return (void*)0;
+        }
+
+        holyc_thread_pool_job_T* job = pool->head;
+        pool->head = job->next;
+
+        if (pool->head == (void*)0)
+            pool->tail = (void*)0;
+
+        pool->active += 1;
+        pthread_mutex_unlock(&pool->lock);
+
+        job->fptr(job->arg);
+        free(job);
+
+        pthread_mutex_lock(&pool->lock);
+        pool->active -= 1;
+
+        if (pool->active == 0 && pool->head == (void*)0)
+            pthread_cond_broadcast(&pool->idle);
+
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+/**
+ * Creates a pool of worker threads.
+ * If threads_size is 0, one thread per online cpu is used.
+ *
+ * @param size_t threads_size
+ *
+ * @return holyc_thread_pool_T*
+ */
+holyc_thread_pool_T* init_holyc_thread_pool(size_t threads_size)
+{
+    holyc_thread_pool_T* pool = calloc(1, sizeof(struct holyc_THREAD_POOL_STRUCT));
+    pool->threads_size = threads_size ? threads_size : holyc_thread_pool_default_size();
+    pool->threads = calloc(pool->threads_size, sizeof(pthread_t));
+    pool->head = (void*)0;
+    pool->tail = (void*)0;
+    pool->active = 0;
+    pool->stopping = 0;
+
+    pthread_mutex_init(&pool->lock, (void*)0);
+    pthread_cond_init(&pool->job_available, (void*)0);
+    pthread_cond_init(&pool->idle, (void*)0);
+
+    for (size_t i = 0; i < pool->threads_size; i++)
+    {
+        if (pthread_create(&pool->threads[i], (void*)0, holyc_thread_pool_worker, pool) != 0)
+        {
+            printf("Error: Could not start worker thread\n");
+            exit(1);
+        }
+    }
+
+    return pool;
+}
+
+/**
+ * Returns the number of online cpus, at least 1.
+ *
+ * @return size_t
+ */
+size_t holyc_thread_pool_default_size()
+{
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return n > 0 ? (size_t) n : 1;
+}
+
+/**
+ * Queues a job, it will be picked up by the first idle worker.
+ *
+ * @param holyc_thread_pool_T* pool
+ * @param void (*fptr)(void* arg)
+ * @param void* arg
+ */
+void holyc_thread_pool_submit(holyc_thread_pool_T* pool, void (*fptr)(void* arg), void* arg)
+{
+    holyc_thread_pool_job_T* job = calloc(1, sizeof(struct holyc_THREAD_POOL_JOB_STRUCT));
+    job->fptr = fptr;
+    job->arg = arg;
+    job->next = (void*)0;
+
+    pthread_mutex_lock(&pool->lock);
+
+    if (pool->tail)
+        pool->tail->next = job;
+    else
+        pool->head = job;
+
+    pool->tail = job;
+
+    pthread_cond_signal(&pool->job_available);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * Blocks until every queued job has finished.
+ * Must not be called from within a job.
+ *
+ * @param holyc_thread_pool_T* pool
+ */
+void holyc_thread_pool_wait(holyc_thread_pool_T* pool)
+{
+    pthread_mutex_lock(&pool->lock);
+
+    while (pool->head != (void*)0 || pool->active > 0)
+        pthread_cond_wait(&pool->idle, &pool->lock);
+
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * Finishes the queued jobs, joins the workers and deallocates the pool.
+ *
+ * @param holyc_thread_pool_T* pool
+ */
+void holyc_thread_pool_free(holyc_thread_pool_T* pool)
+{
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = 1;
+    pthread_cond_broadcast(&pool->job_available);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (size_t i = 0; i < pool->threads_size; i++)
+        pthread_join(pool->threads[i], (void*)0);
+
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->job_available);
+    pthread_cond_destroy(&pool->idle);
+
+    free(pool->threads);
+    free(pool);
+}
@@ -0,0 +1,144 @@
+#include "include/holyc_token_buffer.h"
+#include <string.h>
+#include <stdio.h>
+
+
+static void* holyc_token_buffer_grow(void* ptr, size_t size)
+{
+    void* tmp = realloc(ptr, size);
+
+    if (tmp == (void*)0)
+    {
+        printf("Error: Out of memory while lexing\n");
+        exit(1);
+    }
+
+    return tmp;
+}
+
+/**
+ * Creates a new token buffer with room for `capacity` tokens and
+ * `text_capacity` chars of token values.
+ *
+ * @param size_t capacity
+ * @param size_t text_capacity
+ *
+ * @return holyc_token_buffer_T*
+ */
+holyc_token_buffer_T* init_holyc_token_buffer(size_t capacity, size_t text_capacity)
+{
+    holyc_token_buffer_T* buffer = calloc(1, sizeof(struct holyc_TOKEN_BUFFER_STRUCT));
+    holyc_token_buffer_reserve(buffer, capacity ? capacity : 16, text_capacity ? text_capacity : 64);
+
+    return buffer;
+}
+
+/**
+ * Makes sure that the buffer can hold at least `capacity` tokens and
+ * `text_capacity` chars without reallocating.
+ *
+ * @param holyc_token_buffer_T* buffer
+ * @param size_t capacity
+ * @param size_t text_capacity
+ */
+void holyc_token_buffer_reserve(holyc_token_buffer_T* buffer, size_t capacity, size_t text_capacity)
+{
+    if (capacity > buffer->capacity)
+    {
+        buffer->kinds = holyc_token_buffer_grow(buffer->kinds, capacity * sizeof(unsigned char));
+        buffer->offsets = holyc_token_buffer_grow(buffer->offsets, capacity * sizeof(size_t));
+        buffer->lengths = holyc_token_buffer_grow(buffer->lengths, capacity * sizeof(size_t));
+        buffer->lines = holyc_token_buffer_grow(buffer->lines, capacity * sizeof(unsigned int));
+        buffer->capacity = capacity;
+    }
+
+    if (text_capacity > buffer->text_capacity)
+    {
+        buffer->text = holyc_token_buffer_grow(buffer->text, text_capacity);
+        buffer->text_capacity = text_capacity;
+    }
+}
+
+/**
+ * Appends a token, the value is copied into the text of the buffer.
+ *
+ * @param holyc_token_buffer_T* buffer
+ * @param int kind
+ * @param const char* value
+ * @param size_t length
+ * @param unsigned int line_n
+ */
+void holyc_token_buffer_push(holyc_token_buffer_T* buffer, int kind, const char* value, size_t length, unsigned int line_n)
+{
+    size_t capacity = buffer->capacity;
+    size_t text_capacity = buffer->text_capacity;
+
+    while (buffer->size + 1 > capacity)
+        capacity *= 2;
+
+    while (buffer->text_size + length + 1 > text_capacity)
+        text_capacity *= 2;
+
+    holyc_token_buffer_reserve(buffer, capacity, text_capacity);
+
+    buffer->kinds[buffer->size] = (unsigned char) kind;
+    buffer->offsets[buffer->size] = buffer->text_size;
+    buffer->lengths[buffer->size] = length;
+    buffer->lines[buffer->size] = line_n;
+    buffer->size += 1;
+
+    memcpy(&buffer->text[buffer->text_size], value, length);
+    buffer->text[buffer->text_size + length] = '\0';
+    buffer->text_size += length + 1;
+}
+
+/**
+ * Appends every token of `other` to `buffer`.
+ *
+ * @param holyc_token_buffer_T* buffer
+ * @param holyc_token_buffer_T* other
+ */
+void holyc_token_buffer_append(holyc_token_buffer_T* buffer, holyc_token_buffer_T* other)
+{
+    holyc_token_buffer_reserve(buffer, buffer->size + other->size, buffer->text_size + other->text_size);
+
+    memcpy(&buffer->kinds[buffer->size], other->kinds, other->size * sizeof(unsigned char));
+    memcpy(&buffer->lengths[buffer->size], other->lengths, other->size * sizeof(size_t));
+    memcpy(&buffer->lines[buffer->size], other->lines, other->size * sizeof(unsigned int));
+
+    for (size_t i = 0; i < other->size; i++)
+        buffer->offsets[buffer->size + i] = other->offsets[i] + buffer->text_size;
+
+    memcpy(&buffer->text[buffer->text_size], other->text, other->text_size);
+
+    buffer->size += other->size;
+    buffer->text_size += other->text_size;
+}
+
+/**
+ * Returns the value of the token at `index`, owned by the buffer.
+ *
+ * @param holyc_token_buffer_T* buffer
+ * @param size_t index
+ *
+ * @return char*
+ */
+char* holyc_token_buffer_value(holyc_token_buffer_T* buffer, size_t index)
+{
+    return &buffer->text[buffer->offsets[index]];
+}
+
+/**
+ * Deallocates a token buffer.
+ *
+ * @param holyc_token_buffer_T* buffer
+ */
+void holyc_token_buffer_free(holyc_token_buffer_T* buffer)
+{
+    free(buffer->kinds);
+    free(buffer->offsets);
+    free(buffer->lengths);
+    free(buffer->lines);
+    free(buffer->text);
+    free(buffer);
+}
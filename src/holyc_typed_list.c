@@ -0,0 +1,254 @@
+#include "include/holyc_typed_list.h"
+#include "include/data_type.h"
+#include <string.h>
+#include <stdio.h>
+
+
+/**
+ * Creates an empty typed list, `type` is one of the HOLYC_TYPED_LIST_*
+ * constants.
+ *
+ * @param int type
+ *
+ * @return holyc_typed_list_T*
+ */
+holyc_typed_list_T* init_holyc_typed_list(int type)
+{
+    holyc_typed_list_T* typed_list = calloc(1, sizeof(struct holyc_TYPED_LIST_STRUCT));
+    typed_list->type = type;
+    typed_list->size = 0;
+    typed_list->capacity = 0;
+    typed_list->data = (void*)0;
+    typed_list->buffer = (void*)0;
+
+    switch (type)
+    {
+        case HOLYC_TYPED_LIST_INT: typed_list->item_size = sizeof(int64_t); break;
+        case HOLYC_TYPED_LIST_FLOAT: typed_list->item_size = sizeof(double); break;
+        default: typed_list->item_size = sizeof(char); break;
+    }
+
+    return typed_list;
+}
+
+/**
+ * Returns the typed list type that can hold `value` without losing
+ * anything, or 0 if it has to stay boxed.
+ *
+ * @param AST_T* value
+ *
+ * @return int
+ */
+int holyc_typed_list_type_of(AST_T* value)
+{
+    if (value == (void*)0)
+        return 0;
+
+    switch (value->type)
+    {
+        // long ints keep their modifier when boxed, so they stay boxed.
+        case AST_INTEGER: return data_type_has_modifier(value->type_value, DATA_TYPE_MODIFIER_LONG) ? 0 : HOLYC_TYPED_LIST_INT;
+        case AST_FLOAT: return HOLYC_TYPED_LIST_FLOAT;
+        case AST_CHAR: return HOLYC_TYPED_LIST_CHAR;
+        default: return 0;
+    }
+}
+
+static void buffer_release(holyc_typed_list_buffer_T* buffer)
+{
+    if (buffer && --buffer->refs == 0)
+        free(buffer);
+}
+
+/**
+ * Makes sure that the list can hold at least `capacity` items without
+ * reallocating, and that nothing else points into its buffer.
+ *
+ * @param holyc_typed_list_T* typed_list
+ * @param size_t capacity
+ */
+void holyc_typed_list_reserve(holyc_typed_list_T* typed_list, size_t capacity)
+{
+    holyc_typed_list_buffer_T* buffer = typed_list->buffer;
+    unsigned int owned = buffer == (void*)0 || (buffer->refs == 1 && typed_list->data == buffer->data);
+
+    if (owned && capacity <= typed_list->capacity)
+        return;
+
+    size_t new_capacity = typed_list->capacity ? typed_list->capacity : 8;
+
+    while (new_capacity < capacity)
+        new_capacity *= 2;
+
+    size_t bytes = sizeof(struct holyc_TYPED_LIST_BUFFER_STRUCT) + new_capacity * typed_list->item_size;
+    holyc_typed_list_buffer_T* new_buffer = owned ? realloc(buffer, bytes) : malloc(bytes);
+
+    if (new_buffer == (void*)0)
+    {
+        printf("Error: Out of memory\n");
+        exit(1);
+    }
+
+    if (!owned)
+    {
+        // copy on write, the old buffer is left to the lists sharing it.
+        if (typed_list->size)
+            memcpy(new_buffer->data, typed_list->data, typed_list->size * typed_list->item_size);
+
+        buffer_release(buffer);
+    }
+
+    new_buffer->refs = 1;
+    typed_list->buffer = new_buffer;
+    typed_list->data = new_buffer->data;
+    typed_list->capacity = new_capacity;
+}
+
+/**
+ * Returns the items of the list for writing, copying them first if the
+ * buffer is shared with another list.
+ *
+ * @param holyc_typed_list_T* typed_list
+ *
+ * @return void*
+ */
+void* holyc_typed_list_mutable_data(holyc_typed_list_T* typed_list)
+{
+    holyc_typed_list_reserve(typed_list, typed_list->size);
+
+    return typed_list->data;
+}
+
+/**
+ * Appends the value of `value` to the list.
+ *
+ * @param holyc_typed_list_T* typed_list
+ * @param AST_T* value
+ *
+ * @return unsigned int 0 if the value is not of the type of the list
+ */
+unsigned int holyc_typed_list_append(holyc_typed_list_T* typed_list, AST_T* value)
+{
+    if (holyc_typed_list_type_of(value) != typed_list->type)
+        return 0;
+
+    holyc_typed_list_reserve(typed_list, typed_list->size + 1);
+
+    switch (typed_list->type)
+    {
+        case HOLYC_TYPED_LIST_INT:
+            ((int64_t*) typed_list->data)[typed_list->size] = ast_int_value(value);
+        break;
+        case HOLYC_TYPED_LIST_FLOAT: ((double*) typed_list->data)[typed_list->size] = value->float_value; break;
+        case HOLYC_TYPED_LIST_CHAR: ((char*) typed_list->data)[typed_list->size] = value->char_value; break;
+    }
+
+    typed_list->size += 1;
+
+    return 1;
+}
+
+/**
+ * Removes the item at `index`, the index must be in range.
+ *
+ * @param holyc_typed_list_T* typed_list
+ * @param size_t index
+ */
+void holyc_typed_list_remove_at(holyc_typed_list_T* typed_list, size_t index)
+{
+    char* data = (char*) holyc_typed_list_mutable_data(typed_list);
+
+    memmove(
+        &data[index * typed_list->item_size],
+        &data[(index + 1) * typed_list->item_size],
+        (typed_list->size - index - 1) * typed_list->item_size
+    );
+
+    typed_list->size -= 1;
+}
+
+/**
+ * Stores the item at `index` in `box`.
+ */
+static AST_T* box_into(holyc_typed_list_T* typed_list, size_t index, AST_T* box)
+{
+    switch (typed_list->type)
+    {
+        case HOLYC_TYPED_LIST_INT:
+            box->type = AST_INTEGER;
+            ast_set_int_value(box, ((int64_t*) typed_list->data)[index]);
+        break;
+        case HOLYC_TYPED_LIST_FLOAT:
+            box->type = AST_FLOAT;
+            box->float_value = (float) ((double*) typed_list->data)[index];
+        break;
+        case HOLYC_TYPED_LIST_CHAR:
+            box->type = AST_CHAR;
+            box->char_value = ((char*) typed_list->data)[index];
+        break;
+    }
+
+    return box;
+}
+
+/**
+ * Returns a new node holding the item at `index`.
+ *
+ * @param holyc_typed_list_T* typed_list
+ * @param size_t index
+ *
+ * @return AST_T*
+ */
+AST_T* holyc_typed_list_box(holyc_typed_list_T* typed_list, size_t index)
+{
+    int type = typed_list->type == HOLYC_TYPED_LIST_INT ? AST_INTEGER : typed_list->type == HOLYC_TYPED_LIST_FLOAT ? AST_FLOAT : AST_CHAR;
+
+    return box_into(typed_list, index, init_ast(type));
+}
+
+/**
+ * Returns a list of the items from `start` up to but not including `end`,
+ * sharing the buffer of `typed_list`. Both must be in range.
+ *
+ * @param holyc_typed_list_T* typed_list
+ * @param size_t start
+ * @param size_t end
+ *
+ * @return holyc_typed_list_T*
+ */
+holyc_typed_list_T* holyc_typed_list_slice(holyc_typed_list_T* typed_list, size_t start, size_t end)
+{
+    holyc_typed_list_T* slice = init_holyc_typed_list(typed_list->type);
+
+    if (typed_list->buffer == (void*)0 || start == end)
+        return slice;
+
+    typed_list->buffer->refs += 1;
+    slice->buffer = typed_list->buffer;
+    slice->data = (char*) typed_list->data + start * typed_list->item_size;
+    slice->size = end - start;
+    slice->capacity = slice->size;
+
+    return slice;
+}
+
+/**
+ * @param holyc_typed_list_T* typed_list
+ *
+ * @return holyc_typed_list_T* a copy of `typed_list`, sharing its buffer
+ */
+holyc_typed_list_T* holyc_typed_list_copy(holyc_typed_list_T* typed_list)
+{
+    return holyc_typed_list_slice(typed_list, 0, typed_list->size);
+}
+
+/**
+ * Deallocates a typed list.
+ *
+ * @param holyc_typed_list_T* typed_list
+ */
+void holyc_typed_list_free(holyc_typed_list_T* typed_list)
+{
+    buffer_release(typed_list->buffer);
+    free(typed_list);
+}
@@ -0,0 +1,229 @@
+#define _POSIX_C_SOURCE 200809L
+#include "include/holyc_writer.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+
+static holyc_writer_T* open_writers = (void*)0;
+
+/**
+ * Writes all queued chunks, continuing after partial writes.
+ *
+ * @return unsigned int 0 if the file descriptor could not be written to
+ */
+static unsigned int write_chunks(holyc_writer_T* writer)
+{
+    struct iovec* chunks = writer->chunks;
+    size_t count = writer->chunk_count;
+
+    writer->chunk_count = 0;
+    writer->length = 0;
+    writer->queued_length = 0;
+
+    while (count > 0)
+    {
+        ssize_t written = writev(writer->fd, chunks, (int) count);
+
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            return 0;
+        }
+
+        while (count > 0 && (size_t) written >= chunks->iov_len)
+        {
+            written -= chunks->iov_len;
+            chunks++;
+            count--;
+        }
+
+        if (count > 0)
+        {
+            chunks->iov_base = (char*) chunks->iov_base + written;
+            chunks->iov_len -= written;
+        }
+    }
+
+    return 1;
+}
+
+static void add_chunk(holyc_writer_T* writer, const char* str, size_t length)
+{
+    if (length == 0)
+        return;
+
+    writer->chunks[writer->chunk_count].iov_base = (void*) str;
+    writer->chunks[writer->chunk_count].iov_len = length;
+    writer->chunk_count += 1;
+}
+
+/**
+ * Queues the buffered chars that are not queued yet.
+ */
+static void queue_buffer(holyc_writer_T* writer)
+{
+    add_chunk(writer, &writer->buffer[writer->queued_length], writer->length - writer->queued_length);
+    writer->queued_length = writer->length;
+}
+
+/**
+ * Creates a writer of `fd` with a buffer of `size` chars.
+ *
+ * @param int fd
+ * @param size_t size 0 for HOLYC_WRITER_DEFAULT_SIZE
+ * @param unsigned int owns_fd if the writer closes `fd` when it is closed
+ *
+ * @return holyc_writer_T*
+ */
+holyc_writer_T* init_holyc_writer(int fd, size_t size, unsigned int owns_fd)
+{
+    holyc_writer_T* writer = calloc(1, sizeof(struct holyc_WRITER_STRUCT));
+    writer->fd = fd;
+    writer->owns_fd = owns_fd;
+    writer->size = size ? size : HOLYC_WRITER_DEFAULT_SIZE;
+    writer->buffer = malloc(writer->size);
+
+    if (writer->buffer == (void*)0)
+    {
+        printf("Error: Out of memory\n");
+        exit(1);
+    }
+
+    if (open_writers == (void*)0)
+        atexit(holyc_writer_flush_all);
+
+    writer->next = open_writers;
+    open_writers = writer;
+
+    return writer;
+}
+
+/**
+ * Queues `length` chars. Chars that fit in the buffer are copied, larger
+ * strings are only referenced, so holyc_writer_flush has to be called
+ * before they are modified or deallocated.
+ *
+ * @param holyc_writer_T* writer
+ * @param const char* str
+ * @param size_t length
+ */
+void holyc_writer_queue(holyc_writer_T* writer, const char* str, size_t length)
+{
+    if (writer->fd < 0)
+    {
+        printf("Error: write() to a closed writer\n");
+        exit(1);
+    }
+
+    if (length < writer->size / 2)
+    {
+        // chars that do not fit are written with the queued ones.
+        if (length > writer->size - writer->length)
+            holyc_writer_flush(writer);
+
+        memcpy(&writer->buffer[writer->length], str, length);
+        writer->length += length;
+
+        return;
+    }
+
+    // the buffered chars and the string go out in the same writev.
+    if (writer->chunk_count + 2 > HOLYC_WRITER_MAX_CHUNKS)
+        holyc_writer_flush(writer);
+
+    queue_buffer(writer);
+    add_chunk(writer, str, length);
+}
+
+/**
+ * Writes `length` chars, which may be modified as soon as this returns.
+ * Strings that are copied into the buffer leave the queued ones queued.
+ *
+ * @param holyc_writer_T* writer
+ * @param const char* str
+ * @param size_t length
+ */
+void holyc_writer_write(holyc_writer_T* writer, const char* str, size_t length)
+{
+    holyc_writer_queue(writer, str, length);
+
+    if (length >= writer->size / 2)
+        holyc_writer_flush(writer);
+}
+
+/**
+ * Writes everything that is buffered or queued.
+ *
+ * @param holyc_writer_T* writer
+ */
+void holyc_writer_flush(holyc_writer_T* writer)
+{
+    if (writer->fd < 0)
+        return;
+
+    queue_buffer(writer);
+
+    if (!write_chunks(writer))
+    {
+        printf("Error: write() failed: %s\n", strerror(errno));
+        exit(1);
+    }
+}
+
+/**
+ * Flushes the writer and closes its file descriptor if it owns it,
+ * writing to a closed writer is an error.
+ *
+ * @param holyc_writer_T* writer
+ */
+void holyc_writer_close(holyc_writer_T* writer)
+{
+    holyc_writer_flush(writer);
+
+    if (writer->owns_fd && writer->fd >= 0)
+        close(writer->fd);
+
+    writer->fd = -1;
+}
+
+/**
+ * Closes and deallocates a writer.
+ *
+ * @param holyc_writer_T* writer
+ */
+void holyc_writer_free(holyc_writer_T* writer)
+{
+    holyc_writer_close(writer);
+
+    holyc_writer_T** link = &open_writers;
+
+    while (*link && *link != writer)
+        link = &(*link)->next;
+
+    if (*link)
+        *link = writer->next;
+
+    free(writer->buffer);
+    free(writer);
+}
+
+/**
+ * Writes what every open writer has buffered or queued, errors are ignored.
+ * Registered with atexit, so that output is not lost when a script does
+ * not close its writers or exits with an error.
+ */
+void holyc_writer_flush_all(void)
+{
+    for (holyc_writer_T* writer = open_writers; writer; writer = writer->next)
+    {
+        if (writer->fd < 0)
+            continue;
+
+        queue_buffer(writer);
+        write_chunks(writer);
+    }
+}
@@ -1,12 +1,15 @@
 #ifndef HOLYC_AST_H
 #define HOLYC_AST_H
 #include <stdio.h>
+#include <stdint.h>
 #include "dynamic_list.h"
 #include "token.h"
 #include "data_type.h"
 
 
 struct RUNTIME_STRUCT;
+struct holyc_TYPED_LIST_STRUCT;
+struct holyc_STRING_STRUCT;
 
 typedef struct AST_STRUCT
 {
@@ -44,7 +47,15 @@ typedef struct AST_STRUCT
         AST_LIST_ACCESS,
         AST_NEW,
         AST_ITERATE,
-        AST_ASSERT
+        AST_ASSERT,
+        AST_DEQUE,
+        AST_MAP,
+        AST_SET,
+        AST_BITSET,
+        AST_HEAP,
+        AST_BUILDER,
+        AST_LINE_READER,
+        AST_WRITER
     } type;
     
     struct AST_STRUCT* function_call_expr;
@@ -54,9 +65,11 @@ typedef struct AST_STRUCT
     long int long_int_value;
     unsigned int boolean_value;
     unsigned int is_object_child;
+    unsigned int definition_pass;
     float float_value;
     char char_value;
     char* string_value;
+    struct holyc_STRING_STRUCT* string_header;
     data_type_T* type_value;
     char* variable_name;
     struct AST_STRUCT* variable_value;
@@ -86,6 +99,8 @@ typedef struct AST_STRUCT
     dynamic_list_T* enum_children;
     void* object_value;
     dynamic_list_T* list_children;
+    /* set instead of list_children for lists of a single scalar type */
+    struct holyc_TYPED_LIST_STRUCT* typed_list;
     dynamic_list_T* function_definitions;
     dynamic_list_T* composition_children;
     struct AST_STRUCT* function_definition_body;
@@ -148,6 +163,29 @@ AST_T* ast_copy_list_access(AST_T* ast);
 AST_T* ast_copy_binop(AST_T* ast);
 AST_T* ast_copy_if(AST_T* ast);
 AST_T* ast_copy_while(AST_T* ast);
+AST_T* ast_copy_deque(AST_T* ast);
+AST_T* ast_copy_map(AST_T* ast);
+AST_T* ast_copy_bitset(AST_T* ast);
+AST_T* ast_copy_heap(AST_T* ast);
+AST_T* ast_copy_builder(AST_T* ast);
+AST_T* ast_copy_value(AST_T* ast);
+
+int64_t ast_int_value(AST_T* ast);
+void ast_set_int_value(AST_T* ast, int64_t value);
+
+size_t ast_list_size(AST_T* ast);
+AST_T* ast_list_get(AST_T* ast, size_t index);
+void ast_list_append_many(AST_T* ast, void** items, size_t items_size);
+void ast_list_remove_at(AST_T* ast, size_t index);
+AST_T* ast_list_slice(AST_T* ast, size_t start, size_t end);
+void ast_list_pack(AST_T* ast);
+void ast_list_unpack(AST_T* ast);
+
+struct holyc_STRING_STRUCT* ast_string_header(AST_T* ast);
+void ast_string_set(AST_T* ast, struct holyc_STRING_STRUCT* string);
+size_t ast_string_length(AST_T* ast);
+AST_T* ast_share_value(AST_T* value);
+unsigned int ast_string_equals(AST_T* a, AST_T* b);
 
 char* ast_to_string(AST_T* ast);
 char* ast_object_to_string(AST_T* ast);
@@ -163,5 +201,14 @@ char* ast_attribute_access_to_string(AST_T* ast);
 char* ast_list_access_to_string(AST_T* ast);
 char* ast_binop_to_string(AST_T* ast);
 char* ast_enum_to_string(AST_T* ast);
+char* ast_deque_to_string(AST_T* ast);
+char* ast_map_to_string(AST_T* ast);
+char* ast_set_to_string(AST_T* ast);
+char* ast_bitset_to_string(AST_T* ast);
+char* ast_heap_to_string(AST_T* ast);
+char* ast_builder_to_string(AST_T* ast);
+
+char* ast_line_reader_to_string(AST_T* ast);
+char* ast_writer_to_string(AST_T* ast);
 
 #endif
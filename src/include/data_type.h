@@ -16,7 +16,13 @@ typedef struct DATA_TYPE_STRUCT
         DATA_TYPE_OBJECT,
         DATA_TYPE_ENUM,
         DATA_TYPE_LIST,
-        DATA_TYPE_SOURCE
+        DATA_TYPE_SOURCE,
+        DATA_TYPE_DEQUE,
+        DATA_TYPE_MAP,
+        DATA_TYPE_SET,
+        DATA_TYPE_BITSET,
+        DATA_TYPE_HEAP,
+        DATA_TYPE_BUILDER
     } type;
 
     int modifiers[3];
@@ -2,18 +2,31 @@
 #define DYNAMIC_LIST_H
 #include <stdlib.h>
 
+/* lists of up to this many items do not allocate any item storage. */
+#define DYNAMIC_LIST_INLINE_CAPACITY 4
+
 
 typedef struct DYNAMIC_LIST_STRUCT
 {
     size_t size;
     size_t item_size;
     void** items;
+    size_t capacity;
+    void* inline_items[DYNAMIC_LIST_INLINE_CAPACITY];
 } dynamic_list_T;
 
 dynamic_list_T* init_dynamic_list(size_t item_size);
 
+void dynamic_list_reserve(dynamic_list_T* dynamic_list, size_t capacity);
+
 void* dynamic_list_append(dynamic_list_T* dynamic_list, void* item);
 
+void dynamic_list_append_many(dynamic_list_T* dynamic_list, void** items, size_t items_size);
+
+void* dynamic_list_insert(dynamic_list_T* dynamic_list, size_t index, void* item);
+
+void* dynamic_list_remove_at(dynamic_list_T* dynamic_list, size_t index);
+
 void dynamic_list_shift_left(dynamic_list_T* dynamic_list, int index);
 
 void dynamic_list_remove(dynamic_list_T* dynamic_list, void* element, void (*free_method)(void* item));
@@ -0,0 +1,38 @@
+#ifndef HOLYC_BITSET_H
+#define HOLYC_BITSET_H
+#include <stdlib.h>
+#include <stdint.h>
+
+
+/**
+ * Fixed number of bits packed into 64 bit words, bit `i` is bit i % 64 of
+ * words[i / 64]. Bits past `size` in the last word are always zero so that
+ * counting can popcount whole words.
+ */
+typedef struct holyc_BITSET_STRUCT
+{
+    size_t size;
+    size_t word_count;
+    uint64_t* words;
+} holyc_bitset_T;
+
+holyc_bitset_T* init_holyc_bitset(size_t size);
+
+void holyc_bitset_set(holyc_bitset_T* bitset, size_t index);
+
+void holyc_bitset_unset(holyc_bitset_T* bitset, size_t index);
+
+unsigned int holyc_bitset_test(holyc_bitset_T* bitset, size_t index);
+
+size_t holyc_bitset_count(holyc_bitset_T* bitset);
+
+size_t holyc_bitset_next(holyc_bitset_T* bitset, size_t index);
+
+holyc_bitset_T* holyc_bitset_union(holyc_bitset_T* a, holyc_bitset_T* b);
+
+holyc_bitset_T* holyc_bitset_intersection(holyc_bitset_T* a, holyc_bitset_T* b);
+
+holyc_bitset_T* holyc_bitset_copy(holyc_bitset_T* bitset);
+
+void holyc_bitset_free(holyc_bitset_T* bitset);
+#endif
@@ -9,10 +9,16 @@ AST_T* holyc_builtin_function_print(runtime_T* runtime, AST_T* self, dynamic_lis
 
 AST_T* holyc_builtin_function_stdoutbuffer(runtime_T* runtime, AST_T* self, dynamic_list_T* args);
 
+AST_T* holyc_builtin_function_flush(runtime_T* runtime, AST_T* self, dynamic_list_T* args);
+
+AST_T* holyc_builtin_function_stdout_mode(runtime_T* runtime, AST_T* self, dynamic_list_T* args);
+
 AST_T* holyc_builtin_function_aprint(runtime_T* runtime, AST_T* self, dynamic_list_T* args);
 
 AST_T* holyc_builtin_function_include(runtime_T* runtime, AST_T* self, dynamic_list_T* args);
 
+AST_T* holyc_builtin_function_include_prewarm(runtime_T* runtime, AST_T* self, dynamic_list_T* args);
+
 AST_T* holyc_builtin_function_wad(runtime_T* runtime, AST_T* self, dynamic_list_T* args);
 
 AST_T* holyc_builtin_function_lad(runtime_T* runtime, AST_T* self, dynamic_list_T* args);
@@ -45,5 +51,31 @@ AST_T* holyc_builtin_function_strrev(runtime_T* runtime, AST_T* self, dynamic_li
 
 AST_T* holyc_builtin_function_ssh(runtime_T* runtime, AST_T* self, dynamic_list_T* args);
 
-static AST_T* INITIALIZED_NOOP;
+AST_T* holyc_builtin_function_sum(runtime_T* runtime, AST_T* self, dynamic_list_T* args);
+
+AST_T* holyc_builtin_function_min(runtime_T* runtime, AST_T* self, dynamic_list_T* args);
+
+AST_T* holyc_builtin_function_max(runtime_T* runtime, AST_T* self, dynamic_list_T* args);
+
+AST_T* holyc_builtin_function_mean(runtime_T* runtime, AST_T* self, dynamic_list_T* args);
+
+AST_T* holyc_builtin_function_dot(runtime_T* runtime, AST_T* self, dynamic_list_T* args);
+
+AST_T* holyc_builtin_function_axpy(runtime_T* runtime, AST_T* self, dynamic_list_T* args);
+
+AST_T* holyc_builtin_function_scale(runtime_T* runtime, AST_T* self, dynamic_list_T* args);
+
+AST_T* holyc_builtin_function_vadd(runtime_T* runtime, AST_T* self, dynamic_list_T* args);
+
+AST_T* holyc_builtin_function_vmul(runtime_T* runtime, AST_T* self, dynamic_list_T* args);
+
+AST_T* holyc_builtin_function_cumsum(runtime_T* runtime, AST_T* self, dynamic_list_T* args);
+
+AST_T* holyc_builtin_function_bitset(runtime_T* runtime, AST_T* self, dynamic_list_T* args);
+
+AST_T* holyc_builtin_function_heap(runtime_T* runtime, AST_T* self, dynamic_list_T* args);
+
+AST_T* holyc_builtin_function_writer(runtime_T* runtime, AST_T* self, dynamic_list_T* args);
+
+extern AST_T* INITIALIZED_NOOP;
 #endif
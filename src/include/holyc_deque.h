@@ -0,0 +1,36 @@
+#ifndef HOLYC_DEQUE_H
+#define HOLYC_DEQUE_H
+#include <stdlib.h>
+
+
+/**
+ * Double ended queue stored in a ring buffer.
+ * Item `i` is at items[(head + i) & (capacity - 1)], the capacity is
+ * always a power of two so that wrapping around is a mask.
+ */
+typedef struct holyc_DEQUE_STRUCT
+{
+    void** items;
+    size_t head;
+    size_t size;
+    size_t capacity;
+} holyc_deque_T;
+
+holyc_deque_T* init_holyc_deque(size_t capacity);
+
+void holyc_deque_push_back(holyc_deque_T* deque, void* item);
+
+void holyc_deque_push_front(holyc_deque_T* deque, void* item);
+
+void* holyc_deque_pop_back(holyc_deque_T* deque);
+
+void* holyc_deque_pop_front(holyc_deque_T* deque);
+
+void* holyc_deque_get(holyc_deque_T* deque, size_t index);
+
+void holyc_deque_clear(holyc_deque_T* deque);
+
+holyc_deque_T* holyc_deque_copy(holyc_deque_T* deque);
+
+void holyc_deque_free(holyc_deque_T* deque);
+#endif
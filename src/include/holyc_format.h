@@ -0,0 +1,24 @@
+#ifndef HOLYC_FORMAT_H
+#define HOLYC_FORMAT_H
+#include <stdlib.h>
+#include <stdint.h>
+
+/* enough for any number formatted by the functions below, with the NUL */
+#define HOLYC_FORMAT_BUFFER_SIZE 48
+
+
+/**
+ * Number formatting into caller provided buffers of at least
+ * HOLYC_FORMAT_BUFFER_SIZE chars. Every function NUL terminates and
+ * returns the number of chars written without the NUL.
+ */
+size_t holyc_format_u32(uint32_t value, char* buffer);
+
+size_t holyc_format_u64(uint64_t value, char* buffer);
+
+size_t holyc_format_i64(int64_t value, char* buffer);
+
+size_t holyc_format_float_fixed(float value, char* buffer);
+
+size_t holyc_format_float_shortest(float value, char* buffer);
+#endif
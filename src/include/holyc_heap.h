@@ -0,0 +1,42 @@
+#ifndef HOLYC_HEAP_H
+#define HOLYC_HEAP_H
+#include "ast.h"
+#include "dynamic_list.h"
+#include "holyc_typed_list.h"
+
+
+/* returns 1 if `a` should be popped before `b` */
+typedef unsigned int (*holyc_heap_less_T)(void* context, AST_T* a, AST_T* b);
+
+/**
+ * Binary heap, the item that is popped first is at index 0 and the
+ * children of item `i` are at 2i + 1 and 2i + 2.
+ * Without a comparator ints or floats are kept unboxed in `keys` and
+ * popped smallest first, the heap falls back to boxed `nodes` once another
+ * kind of item is pushed. With a comparator the items are always boxed.
+ * The context of the comparator is not owned by the heap.
+ */
+typedef struct holyc_HEAP_STRUCT
+{
+    holyc_typed_list_T* keys;
+    dynamic_list_T* nodes;
+    holyc_heap_less_T less;
+    void* context;
+} holyc_heap_T;
+
+holyc_heap_T* init_holyc_heap(holyc_heap_less_T less, void* context);
+
+size_t holyc_heap_size(holyc_heap_T* heap);
+
+void holyc_heap_push(holyc_heap_T* heap, AST_T* item);
+
+void holyc_heap_push_many(holyc_heap_T* heap, AST_T** items, size_t size);
+
+AST_T* holyc_heap_peek(holyc_heap_T* heap);
+
+AST_T* holyc_heap_pop(holyc_heap_T* heap);
+
+holyc_heap_T* holyc_heap_copy(holyc_heap_T* heap);
+
+void holyc_heap_free(holyc_heap_T* heap);
+#endif
@@ -0,0 +1,66 @@
+#ifndef HOLYC_INCLUDE_CACHE_H
+#define HOLYC_INCLUDE_CACHE_H
+#include "ast.h"
+#include "holyc_hashmap.h"
+#include "holyc_thread_pool.h"
+#include "dynamic_list.h"
+#include <stdint.h>
+#include <sys/types.h>
+#include <time.h>
+
+
+typedef struct holyc_INCLUDE_CACHE_ENTRY_STRUCT
+{
+    char* path;
+    AST_T* node;
+
+    /* the parse error of a prefetched file, reported once it is included */
+    char* error;
+
+    /* set while a worker is parsing the file, guarded by the cache lock */
+    unsigned int pending;
+    struct holyc_INCLUDE_CACHE_STRUCT* cache;
+
+    /* ==== what the file looked like when it was parsed ==== */
+    time_t mtime_sec;
+    long mtime_nsec;
+    off_t size;
+    uint32_t hash;
+} holyc_include_cache_entry_T;
+
+typedef map_t(holyc_include_cache_entry_T*) holyc_include_cache_map_T;
+
+/**
+ * Parsed includes, keyed by canonical path.
+ * Literal include paths found while parsing are parsed ahead of time on
+ * `pool`, holyc_include_cache_get waits for them if they are not done yet.
+ * Since those includes may never be reached, their parse errors are kept
+ * on the entry and only reported by holyc_include_cache_get.
+ */
+typedef struct holyc_INCLUDE_CACHE_STRUCT
+{
+    holyc_include_cache_map_T entries;
+    unsigned int hits;
+    unsigned int misses;
+
+    holyc_thread_pool_T* pool;
+    pthread_mutex_t lock;
+    pthread_cond_t parsed;
+} holyc_include_cache_T;
+
+holyc_include_cache_T* init_holyc_include_cache();
+
+AST_T* holyc_include_cache_parse_file(const char* filename);
+
+AST_T* holyc_include_cache_get(holyc_include_cache_T* cache, const char* filename);
+
+void holyc_include_cache_prefetch(holyc_include_cache_T* cache, dynamic_list_T* paths);
+
+unsigned int holyc_include_cache_prewarm(holyc_include_cache_T* cache, const char* manifest);
+
+void holyc_include_cache_prepare_fork(holyc_include_cache_T* cache);
+
+void holyc_include_cache_forked(holyc_include_cache_T* cache);
+
+void holyc_include_cache_free(holyc_include_cache_T* cache);
+#endif
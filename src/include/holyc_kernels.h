@@ -0,0 +1,38 @@
+#ifndef HOLYC_KERNELS_H
+#define HOLYC_KERNELS_H
+#include <stdlib.h>
+#include <stdint.h>
+
+
+/**
+ * Numeric kernels over contiguous int64_t and double arrays, used by the
+ * list builtins on typed lists.
+ * Compiled with AVX/AVX2 when the compiler targets it (-mavx2, -march=native),
+ * with SSE2 otherwise on x86-64, and as plain C everywhere else.
+ * Floating point reductions are not summed strictly left to right, so they
+ * may round differently than a loop in script.
+ */
+int64_t holyc_kernel_sum_i64(const int64_t* x, size_t n);
+double holyc_kernel_sum_f64(const double* x, size_t n);
+
+int64_t holyc_kernel_min_i64(const int64_t* x, size_t n);
+double holyc_kernel_min_f64(const double* x, size_t n);
+
+int64_t holyc_kernel_max_i64(const int64_t* x, size_t n);
+double holyc_kernel_max_f64(const double* x, size_t n);
+
+int64_t holyc_kernel_dot_i64(const int64_t* x, const int64_t* y, size_t n);
+double holyc_kernel_dot_f64(const double* x, const double* y, size_t n);
+
+void holyc_kernel_axpy_i64(int64_t a, const int64_t* x, int64_t* y, size_t n);
+void holyc_kernel_axpy_f64(double a, const double* x, double* y, size_t n);
+
+void holyc_kernel_add_i64(const int64_t* x, const int64_t* y, int64_t* out, size_t n);
+void holyc_kernel_add_f64(const double* x, const double* y, double* out, size_t n);
+
+void holyc_kernel_mul_i64(const int64_t* x, const int64_t* y, int64_t* out, size_t n);
+void holyc_kernel_mul_f64(const double* x, const double* y, double* out, size_t n);
+
+void holyc_kernel_cumsum_i64(const int64_t* x, int64_t* out, size_t n);
+void holyc_kernel_cumsum_f64(const double* x, double* out, size_t n);
+#endif
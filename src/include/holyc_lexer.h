@@ -1,6 +1,7 @@
 #ifndef HOLYC_LEXER_H
 #define HOLYC_LEXER_H
 #include "token.h"
+#include "holyc_token_buffer.h"
 #include <stdlib.h>
 
 
@@ -12,15 +13,24 @@ typedef struct holyc_LEXER_STRUCT
     char current_char;
     unsigned int char_index;
     unsigned int line_n;
+
+    /* ==== every token of the contents, filled before parsing ==== */
+    holyc_token_buffer_T* tokens;
 } holyc_lexer_T;
 
 holyc_lexer_T* init_holyc_lexer(char* contents);
 
 void holyc_lexer_free(holyc_lexer_T* holyc_lexer);
 
+void holyc_lexer_tokenize(holyc_lexer_T* holyc_lexer, holyc_token_buffer_T* buffer);
+
 token_T* holyc_lexer_get_next_token(holyc_lexer_T* holyc_lexer);
 
-token_T* holyc_lexer_advance_with_token(holyc_lexer_T* holyc_lexer, int type);
+int holyc_lexer_scan_token(holyc_lexer_T* holyc_lexer, size_t* start, size_t* length);
+
+int holyc_lexer_advance_with_token(holyc_lexer_T* holyc_lexer, size_t* length, int type);
+
+int holyc_lexer_collect_operator(holyc_lexer_T* holyc_lexer, size_t* start, size_t* length, int type, char next, int next_type);
 
 void holyc_lexer_advance(holyc_lexer_T* holyc_lexer);
 
@@ -32,13 +42,13 @@ void holyc_lexer_skip_inline_comment(holyc_lexer_T* holyc_lexer);
 
 void holyc_lexer_skip_block_comment(holyc_lexer_T* holyc_lexer);
 
-token_T* holyc_lexer_collect_string(holyc_lexer_T* holyc_lexer);
+int holyc_lexer_collect_string(holyc_lexer_T* holyc_lexer, size_t* start, size_t* length);
 
-token_T* holyc_lexer_collect_char(holyc_lexer_T* holyc_lexer);
+int holyc_lexer_collect_char(holyc_lexer_T* holyc_lexer, size_t* start, size_t* length);
 
-token_T* holyc_lexer_collect_number(holyc_lexer_T* holyc_lexer);
+int holyc_lexer_collect_number(holyc_lexer_T* holyc_lexer, size_t* start, size_t* length);
 
-token_T* holyc_lexer_collect_id(holyc_lexer_T* holyc_lexer);
+int holyc_lexer_collect_id(holyc_lexer_T* holyc_lexer, size_t* start, size_t* length);
 
 char* holyc_lexer_current_charstr(holyc_lexer_T* holyc_lexer);
 #endif
@@ -0,0 +1,32 @@
+#ifndef HOLYC_LINE_READER_H
+#define HOLYC_LINE_READER_H
+#include <stdlib.h>
+
+/* initial size of the buffer, it grows for lines that do not fit */
+#define HOLYC_LINE_READER_SIZE (1 << 20)
+
+
+/**
+ * Reads a file descriptor a line at a time through one reusable buffer,
+ * so that files can be processed without loading them whole.
+ * The buffer is allocated on the first read and released once the end
+ * of the input is reached.
+ */
+typedef struct holyc_LINE_READER_STRUCT
+{
+    int fd;
+    char* buffer;
+    size_t size;
+    /* unread chars are buffer[start..end), buffer[start..scanned) has no newline */
+    size_t start;
+    size_t scanned;
+    size_t end;
+    unsigned int eof;
+} holyc_line_reader_T;
+
+holyc_line_reader_T* init_holyc_line_reader(int fd);
+
+const char* holyc_line_reader_next(holyc_line_reader_T* reader, size_t* length);
+
+void holyc_line_reader_free(holyc_line_reader_T* reader);
+#endif
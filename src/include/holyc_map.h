@@ -0,0 +1,42 @@
+#ifndef HOLYC_MAP_H
+#define HOLYC_MAP_H
+#include "ast.h"
+#include "holyc_hashmap.h"
+
+
+typedef struct holyc_MAP_ENTRY_STRUCT
+{
+    AST_T* key;
+    AST_T* value;
+} holyc_map_entry_T;
+
+typedef map_t(holyc_map_entry_T*) holyc_map_entries_T;
+
+/**
+ * Values keyed by strings or ints, stored in a hashmap.
+ * The hashmap is keyed by strings, so keys are encoded with a prefix for
+ * their type: "s" + the string or "i" + the int in decimal.
+ */
+typedef struct holyc_MAP_STRUCT
+{
+    holyc_map_entries_T entries;
+} holyc_map_T;
+
+holyc_map_T* init_holyc_map();
+
+unsigned int holyc_map_is_key(AST_T* key);
+
+holyc_map_entry_T* holyc_map_get(holyc_map_T* map, AST_T* key);
+
+void holyc_map_set(holyc_map_T* map, AST_T* key, AST_T* value);
+
+unsigned int holyc_map_remove(holyc_map_T* map, AST_T* key);
+
+size_t holyc_map_size(holyc_map_T* map);
+
+holyc_map_entry_T* holyc_map_next(holyc_map_T* map, map_iter_t* iter);
+
+holyc_map_T* holyc_map_copy(holyc_map_T* map);
+
+void holyc_map_free(holyc_map_T* map);
+#endif
@@ -0,0 +1,106 @@
+#ifndef HOLYC_MODULE_H
+#define HOLYC_MODULE_H
+#include "ast.h"
+#include <stdint.h>
+
+
+/**
+ * Compiled modules, a parsed program stored on disk.
+ *
+ * A module is a header followed by these sections, in order:
+ *
+ *   nodes   holyc_module_node_T[nodes_size]
+ *   edges   holyc_module_edge_T[edges_size]
+ *   lists   holyc_module_list_T[lists_size]
+ *   items   int32_t[items_size]
+ *   scopes  holyc_module_scope_T[scopes_size]
+ *   strings NUL terminated strings, strings_size bytes
+ *
+ * Nodes never reference each other by address, edges and list items hold
+ * the index of the target node relative to the index of the node they
+ * belong to, so a module can be mapped anywhere.
+ * Bump HOLYC_MODULE_VERSION whenever a record or one of the field tables
+ * in holyc_module.c changes, or the parser starts producing node or data
+ * types that an older version would not understand.
+ *
+ * Version 2 added map literals (AST_MAP) and the container data types.
+ */
+#define HOLYC_MODULE_MAGIC "HOLYCMOD"
+#define HOLYC_MODULE_MAGIC_SIZE 8
+#define HOLYC_MODULE_VERSION 2
+#define HOLYC_MODULE_BYTE_ORDER 0x01020304
+
+typedef struct holyc_MODULE_HEADER_STRUCT
+{
+    char magic[HOLYC_MODULE_MAGIC_SIZE];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t checksum;  /* FNV-1a of everything after the header */
+    uint32_t root;
+
+    uint32_t nodes_size;
+    uint32_t edges_size;
+    uint32_t lists_size;
+    uint32_t items_size;
+    uint32_t scopes_size;
+    uint32_t strings_size;
+} holyc_module_header_T;
+
+typedef struct holyc_MODULE_NODE_STRUCT
+{
+    uint32_t type;
+    int32_t line_n;
+    int32_t int_value;
+    uint32_t boolean_value;
+    int64_t long_int_value;
+    uint32_t is_object_child;
+    float float_value;
+    int32_t char_value;
+
+    /* ==== offset + 1 into the strings, 0 is NULL ==== */
+    uint32_t string_value;
+    uint32_t variable_name;
+    uint32_t function_name;
+
+    /* ==== -1 is NULL ==== */
+    int32_t type_value;
+    int32_t type_modifiers[3];
+    int32_t binop_operator_type;
+    uint32_t binop_operator_value;
+    int32_t unop_operator_type;
+    uint32_t unop_operator_value;
+    int32_t scope;
+
+    uint32_t first_edge;
+    uint32_t edges_size;
+    uint32_t first_list;
+    uint32_t lists_size;
+} holyc_module_node_T;
+
+typedef struct holyc_MODULE_EDGE_STRUCT
+{
+    uint16_t field;
+    uint16_t padding;
+    int32_t target;
+} holyc_module_edge_T;
+
+typedef struct holyc_MODULE_LIST_STRUCT
+{
+    uint16_t field;
+    uint16_t padding;
+    uint32_t first_item;
+    uint32_t items_size;
+} holyc_module_list_T;
+
+typedef struct holyc_MODULE_SCOPE_STRUCT
+{
+    int32_t owner;
+    uint32_t global;
+} holyc_module_scope_T;
+
+unsigned int holyc_module_is_module(const char* filename);
+
+void holyc_module_write(AST_T* root, const char* filename);
+
+AST_T* holyc_module_load(const char* filename);
+#endif
@@ -0,0 +1,43 @@
+#ifndef HOLYC_OUTPUT_H
+#define HOLYC_OUTPUT_H
+#include "ast.h"
+#include <stdlib.h>
+
+#define HOLYC_OUTPUT_LINE_BUFFERED 1
+#define HOLYC_OUTPUT_FULLY_BUFFERED 2
+
+#define HOLYC_OUTPUT_DEFAULT_SIZE (64 * 1024)
+
+/* the environment variable with the size of the buffer of stdout in bytes */
+#define HOLYC_OUTPUT_SIZE_VARIABLE "HOLYC_STDOUT_BUFFER"
+
+
+/**
+ * The output of the runtime. A buffer of `size` chars is installed as the
+ * buffer of stdout once, before anything is written, since stdio does not
+ * allow changing it later. Everything written to stdout goes through it,
+ * including printf, so output stays in order, and it is flushed by stdio
+ * on exit.
+ * `mode` only decides when it is flushed: line buffered output is flushed
+ * by holyc_output_write after every newline, fully buffered output when
+ * the buffer is full. Line buffered is the default on a terminal, fully
+ * buffered everywhere else.
+ */
+typedef struct holyc_OUTPUT_STRUCT
+{
+    size_t size;
+    int mode;
+} holyc_output_T;
+
+holyc_output_T* init_holyc_output(int mode, size_t size);
+
+void holyc_output_set_mode(holyc_output_T* output, int mode);
+
+void holyc_output_write(holyc_output_T* output, const char* str, size_t length);
+
+void holyc_output_write_value(holyc_output_T* output, AST_T* value);
+
+void holyc_output_flush(holyc_output_T* output);
+
+void holyc_output_free(holyc_output_T* output);
+#endif
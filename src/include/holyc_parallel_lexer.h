@@ -0,0 +1,12 @@
+#ifndef HOLYC_PARALLEL_LEXER_H
+#define HOLYC_PARALLEL_LEXER_H
+#include "holyc_lexer.h"
+
+/* sources smaller than this are lexed on the calling thread. */
+#define HOLYC_PARALLEL_LEXER_THRESHOLD (1024 * 1024)
+
+/* a chunk is never smaller than this. */
+#define HOLYC_PARALLEL_LEXER_MIN_CHUNK (64 * 1024)
+
+void holyc_parallel_lexer_tokenize(holyc_lexer_T* holyc_lexer);
+#endif
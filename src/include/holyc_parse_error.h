@@ -0,0 +1,38 @@
+#ifndef HOLYC_PARSE_ERROR_H
+#define HOLYC_PARSE_ERROR_H
+#include <setjmp.h>
+
+/* the longest message that is kept for a caught error */
+#define HOLYC_PARSE_ERROR_SIZE 512
+
+
+/**
+ * Errors found while lexing, parsing or loading a module.
+ *
+ * An error is printed and the program exits, unless the current thread
+ * has set a catcher. Then the message is stored in the catcher and the
+ * thread jumps back to `jump`, abandoning the parse. This is used to parse
+ * includes ahead of time without failing for files that are never reached.
+ *
+ *     holyc_parse_error_catcher_T catcher;
+ *
+ *     if (setjmp(catcher.jump) == 0)
+ *     {
+ *         holyc_parse_error_catch(&catcher);
+ *         ... parse ...
+ *     }
+ *
+ *     holyc_parse_error_catch((void*)0);
+ */
+typedef struct holyc_PARSE_ERROR_CATCHER_STRUCT
+{
+    jmp_buf jump;
+    char message[HOLYC_PARSE_ERROR_SIZE];
+} holyc_parse_error_catcher_T;
+
+void holyc_parse_error_catch(holyc_parse_error_catcher_T* catcher);
+
+unsigned int holyc_parse_error_catching();
+
+void holyc_parse_error(const char* format, ...);
+#endif
@@ -9,13 +9,25 @@
 typedef struct holyc_PARSER_STRUCT
 {
     holyc_lexer_T* holyc_lexer;
+    holyc_token_buffer_T* tokens;
+    size_t token_index;
+
+    /* ==== views into `tokens`, never freed ==== */
+    token_T prev_token_view;
+    token_T current_token_view;
     token_T* prev_token;
     token_T* current_token;
+
     data_type_T* data_type;
+
+    /* ==== paths of every include("...") with a literal path ==== */
+    dynamic_list_T* include_paths;
 } holyc_parser_T;
 
 holyc_parser_T* init_holyc_parser(holyc_lexer_T* holyc_lexer);
 
+void holyc_parser_free(holyc_parser_T* holyc_parser);
+
 // etc
 
 void holyc_parser_type_error(holyc_parser_T* holyc_parser);
@@ -28,6 +40,8 @@ AST_T* holyc_parser_parse(holyc_parser_T* holyc_parser, holyc_scope_T* scope);
 
 AST_T* holyc_parser_eat(holyc_parser_T* holyc_parser, int token_type);
 
+int holyc_parser_peek(holyc_parser_T* holyc_parser, size_t offset);
+
 AST_T* holyc_parser_parse_statement(holyc_parser_T* holyc_parser, holyc_scope_T* scope);
 
 AST_T* holyc_parser_parse_statements(holyc_parser_T* holyc_parser, holyc_scope_T* scope);
@@ -56,6 +70,8 @@ AST_T* holyc_parser_parse_enum(holyc_parser_T* holyc_parser, holyc_scope_T* scop
 
 AST_T* holyc_parser_parse_list(holyc_parser_T* holyc_parser, holyc_scope_T* scope);
 
+AST_T* holyc_parser_parse_map(holyc_parser_T* holyc_parser, holyc_scope_T* scope);
+
 // math
 
 AST_T* holyc_parser_parse_factor(holyc_parser_T* holyc_parser, holyc_scope_T* scope);
@@ -7,17 +7,64 @@ typedef struct RUNTIME_STRUCT
 {
     holyc_scope_T* scope;
     dynamic_list_T* list_methods;
-    char* stdout_buffer;
+    dynamic_list_T* string_methods;
+    dynamic_list_T* deque_methods;
+    dynamic_list_T* map_methods;
+    dynamic_list_T* set_methods;
+    dynamic_list_T* bitset_methods;
+    dynamic_list_T* heap_methods;
+    dynamic_list_T* builder_methods;
+    dynamic_list_T* line_reader_methods;
+    dynamic_list_T* writer_methods;
+    struct holyc_STRING_STRUCT* stdout_buffer;
+    struct holyc_OUTPUT_STRUCT* output;
+    struct AST_STRUCT* stdin_reader;
+    struct holyc_INCLUDE_CACHE_STRUCT* include_cache;
+    unsigned int definition_pass;
+    unsigned int definition_passes;
 } runtime_T;
 
+/**
+ * A script function used to order items, it is called with two items and
+ * returns true if the first one should come first.
+ */
+typedef struct RUNTIME_COMPARATOR_STRUCT
+{
+    runtime_T* runtime;
+    AST_T* fdef;
+    dynamic_list_T* args;
+} runtime_comparator_T;
+
+AST_T* runtime_call_function(runtime_T* runtime, AST_T* fdef, dynamic_list_T* args);
+
+runtime_comparator_T* init_runtime_comparator(runtime_T* runtime, AST_T* fdef);
+
+unsigned int runtime_comparator_less(void* context, AST_T* a, AST_T* b);
+
+void runtime_comparator_free(runtime_comparator_T* comparator);
+
+unsigned int _boolean_evaluation(AST_T* node);
+
 AST_T* runtime_register_global_function(runtime_T* runtime, char* fname, struct AST_STRUCT* (*fptr)(struct RUNTIME_STRUCT* runtime, struct AST_STRUCT* self, dynamic_list_T* args));
 
 AST_T* runtime_register_global_variable(runtime_T* runtime, char* vname, char* vval);
 
 runtime_T* init_runtime();
 
+AST_T* runtime_init_line_reader(runtime_T* runtime, int fd);
+
+AST_T* runtime_init_writer(runtime_T* runtime, int fd, size_t size, unsigned int owns_fd);
+
 AST_T* runtime_visit(runtime_T* runtime, AST_T* node);
 
+void runtime_run_script(runtime_T* runtime, AST_T* node);
+
+AST_T* runtime_run_include(runtime_T* runtime, AST_T* node);
+
+void runtime_set_args(runtime_T* runtime, int argc, char** argv);
+
+void runtime_visit_lines(runtime_T* runtime, AST_T* node, unsigned int print_lines);
+
 AST_T* runtime_visit_variable(runtime_T* runtime, AST_T* node);
 
 AST_T* runtime_visit_variable_definition(runtime_T* runtime, AST_T* node);
@@ -44,6 +91,8 @@ AST_T* runtime_visit_enum(runtime_T* runtime, AST_T* node);
 
 AST_T* runtime_visit_list(runtime_T* runtime, AST_T* node);
 
+AST_T* runtime_visit_map(runtime_T* runtime, AST_T* node);
+
 AST_T* runtime_visit_boolean(runtime_T* runtime, AST_T* node);
 
 AST_T* runtime_visit_integer(runtime_T* runtime, AST_T* node);
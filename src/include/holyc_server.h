@@ -0,0 +1,45 @@
+#ifndef HOLYC_SERVER_H
+#define HOLYC_SERVER_H
+#include "holyc_runtime.h"
+
+/* the largest request a client can send */
+#define HOLYC_SERVER_REQUEST_SIZE (64 * 1024)
+
+/* the most arguments a script can be given, plus the directory and path */
+#define HOLYC_SERVER_MAX_FIELDS 1024
+
+/* sent after the output of a script, followed by its exit status as one byte */
+#define HOLYC_SERVER_STATUS_MARK "\0holyc-exit-status"
+#define HOLYC_SERVER_STATUS_MARK_SIZE (sizeof(HOLYC_SERVER_STATUS_MARK) - 1)
+
+
+/**
+ * Serves script executions over a Unix socket.
+ * A request is the working directory of the client, the path of a script
+ * and its arguments, each terminated by a NUL char, followed by the end of
+ * the client's side of the connection. The output of the script is
+ * written to the connection, followed by HOLYC_SERVER_STATUS_MARK and the
+ * exit status of the script, 0 if it ran to the end and 1 if it failed.
+ * The connection is closed when the script is done.
+ *
+ * The server forks `workers` processes from a process that has already
+ * initialized its runtime. Every worker accepts requests one at a time
+ * and keeps the scripts it has run parsed in its include cache. A worker
+ * that exits, e.g because a script had an error, is replaced by a new one.
+ * The global definitions a script makes are dropped after it ran, but
+ * requests run by the same worker share its process: state outside of the
+ * global scope, such as the stdout mode, writers that were not closed or
+ * native libraries, is seen by the requests that worker runs next. Use
+ * holyc_server_fork_serve when requests have to be independent.
+ */
+int holyc_server_serve(runtime_T* runtime, const char* socket_path, size_t workers);
+
+/**
+ * Serves the same requests by forking a child per request from a process
+ * that has run a prelude and parsed the scripts it serves. Children share
+ * that memory copy-on-write and do not affect each other or the server.
+ */
+int holyc_server_fork_serve(runtime_T* runtime, const char* socket_path, const char* prelude, int scripts_size, char** scripts);
+
+int holyc_server_connect(const char* socket_path, int argc, char** argv);
+#endif
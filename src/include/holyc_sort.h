@@ -0,0 +1,25 @@
+#ifndef HOLYC_SORT_H
+#define HOLYC_SORT_H
+#include "ast.h"
+#include "holyc_typed_list.h"
+#include <stdint.h>
+
+/* lists of at least this many items are sorted on a thread pool */
+#define HOLYC_SORT_PARALLEL_THRESHOLD (1 << 17)
+
+
+/* returns 1 if `a` should be ordered before `b` */
+typedef unsigned int (*holyc_sort_less_T)(void* context, AST_T* a, AST_T* b);
+
+unsigned int holyc_sort_less_by_value(void* context, AST_T* a, AST_T* b);
+
+void holyc_sort_i64(int64_t* x, size_t n);
+
+void holyc_sort_f64(double* x, size_t n);
+
+void holyc_sort_char(char* x, size_t n);
+
+void holyc_sort_typed_list(holyc_typed_list_T* typed_list);
+
+void holyc_sort_nodes(AST_T** items, size_t n, holyc_sort_less_T less, void* context);
+#endif
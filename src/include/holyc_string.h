@@ -0,0 +1,39 @@
+#ifndef HOLYC_STRING_H
+#define HOLYC_STRING_H
+#include <stdlib.h>
+#include <stdint.h>
+
+
+/**
+ * Header allocated in front of the chars of a runtime string.
+ * `data` is NUL terminated, so it can be used as the string_value of a
+ * node, `capacity` is the number of chars that fit without the NUL.
+ * The hash is computed the first time it is needed.
+ * `unique` is set while only one variable refers to the string, so that
+ * it can be appended to in place.
+ * Strings of mapped files are read only, `mapped` is the size of their
+ * mapping and they are copied before they grow.
+ */
+typedef struct holyc_STRING_STRUCT
+{
+    size_t length;
+    size_t capacity;
+    uint32_t hash;
+    unsigned int hashed;
+    unsigned int unique;
+    size_t mapped;
+    char data[];
+} holyc_string_T;
+
+holyc_string_T* init_holyc_string(const char* value, size_t length);
+
+holyc_string_T* holyc_string_reserve(holyc_string_T* string, size_t capacity);
+
+holyc_string_T* holyc_string_append(holyc_string_T* string, const char* value, size_t length);
+
+holyc_string_T* holyc_string_map_file(int fd);
+
+uint32_t holyc_string_hash(holyc_string_T* string);
+
+void holyc_string_free(holyc_string_T* string);
+#endif
@@ -0,0 +1,40 @@
+#ifndef HOLYC_STRING_SEARCH_H
+#define HOLYC_STRING_SEARCH_H
+#include <stdlib.h>
+
+/* returned by the find functions when there is no match */
+#define HOLYC_STRING_NOT_FOUND ((size_t) -1)
+
+/* needles at least this long are searched for with the two-way algorithm */
+#define HOLYC_STRING_TWO_WAY_THRESHOLD 32
+
+
+/**
+ * A needle prepared for searching, so that splitting, counting and
+ * replacing only analyze it once.
+ * Single chars are found with memchr, short needles by comparing their
+ * first and last char against a block of the haystack at a time
+ * (SSE2 when the compiler targets it), and long needles with the two-way
+ * algorithm, which is linear in the length of the haystack.
+ */
+typedef struct holyc_STRING_SEARCHER_STRUCT
+{
+    const char* needle;
+    size_t length;
+    /* two-way, critical position and period of the needle */
+    size_t critical;
+    size_t period;
+    unsigned int periodic;
+    size_t* shift;
+} holyc_string_searcher_T;
+
+holyc_string_searcher_T* init_holyc_string_searcher(const char* needle, size_t length);
+
+size_t holyc_string_searcher_find(holyc_string_searcher_T* searcher, const char* haystack, size_t length);
+
+void holyc_string_searcher_free(holyc_string_searcher_T* searcher);
+
+size_t holyc_string_find(const char* haystack, size_t haystack_length, const char* needle, size_t needle_length);
+
+size_t holyc_string_count_char(const char* haystack, size_t length, char c);
+#endif
@@ -0,0 +1,38 @@
+#ifndef HOLYC_THREAD_POOL_H
+#define HOLYC_THREAD_POOL_H
+#include <pthread.h>
+#include <stdlib.h>
+
+
+typedef struct holyc_THREAD_POOL_JOB_STRUCT
+{
+    void (*fptr)(void* arg);
+    void* arg;
+    struct holyc_THREAD_POOL_JOB_STRUCT* next;
+} holyc_thread_pool_job_T;
+
+typedef struct holyc_THREAD_POOL_STRUCT
+{
+    pthread_t* threads;
+    size_t threads_size;
+
+    holyc_thread_pool_job_T* head;
+    holyc_thread_pool_job_T* tail;
+    size_t active;
+    unsigned int stopping;
+
+    pthread_mutex_t lock;
+    pthread_cond_t job_available;
+    pthread_cond_t idle;
+} holyc_thread_pool_T;
+
+holyc_thread_pool_T* init_holyc_thread_pool(size_t threads_size);
+
+size_t holyc_thread_pool_default_size();
+
+void holyc_thread_pool_submit(holyc_thread_pool_T* pool, void (*fptr)(void* arg), void* arg);
+
+void holyc_thread_pool_wait(holyc_thread_pool_T* pool);
+
+void holyc_thread_pool_free(holyc_thread_pool_T* pool);
+#endif
@@ -0,0 +1,36 @@
+#ifndef HOLYC_TOKEN_BUFFER_H
+#define HOLYC_TOKEN_BUFFER_H
+#include <stdlib.h>
+
+
+/**
+ * All tokens of a source, stored as a structure of arrays.
+ * Token `i` is of type kinds[i], was lexed on lines[i] and its value is the
+ * NUL terminated string of lengths[i] chars at text + offsets[i].
+ */
+typedef struct holyc_TOKEN_BUFFER_STRUCT
+{
+    unsigned char* kinds;
+    size_t* offsets;
+    size_t* lengths;
+    unsigned int* lines;
+    size_t size;
+    size_t capacity;
+
+    char* text;
+    size_t text_size;
+    size_t text_capacity;
+} holyc_token_buffer_T;
+
+holyc_token_buffer_T* init_holyc_token_buffer(size_t capacity, size_t text_capacity);
+
+void holyc_token_buffer_reserve(holyc_token_buffer_T* buffer, size_t capacity, size_t text_capacity);
+
+void holyc_token_buffer_push(holyc_token_buffer_T* buffer, int kind, const char* value, size_t length, unsigned int line_n);
+
+void holyc_token_buffer_append(holyc_token_buffer_T* buffer, holyc_token_buffer_T* other);
+
+char* holyc_token_buffer_value(holyc_token_buffer_T* buffer, size_t index);
+
+void holyc_token_buffer_free(holyc_token_buffer_T* buffer);
+#endif
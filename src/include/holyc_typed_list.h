@@ -0,0 +1,57 @@
+#ifndef HOLYC_TYPED_LIST_H
+#define HOLYC_TYPED_LIST_H
+#include "ast.h"
+#include <stdint.h>
+
+#define HOLYC_TYPED_LIST_INT 1
+#define HOLYC_TYPED_LIST_FLOAT 2
+#define HOLYC_TYPED_LIST_CHAR 3
+
+
+/**
+ * Reference counted memory that typed lists and their slices point into.
+ */
+typedef struct holyc_TYPED_LIST_BUFFER_STRUCT
+{
+    unsigned int refs;
+    char data[];
+} holyc_typed_list_buffer_T;
+
+/**
+ * Unboxed storage for lists whose items are all of the same scalar type.
+ * `data` is an array of `size` int64_t, double or char depending on `type`,
+ * items are only turned into AST nodes when they leave the list.
+ * Copies and slices share the buffer of the list they were made from, a
+ * list copies its items into a buffer of its own before it is mutated
+ * while the buffer is shared.
+ */
+typedef struct holyc_TYPED_LIST_STRUCT
+{
+    int type;
+    size_t item_size;
+    size_t size;
+    size_t capacity;
+    void* data;
+    holyc_typed_list_buffer_T* buffer;
+} holyc_typed_list_T;
+
+holyc_typed_list_T* init_holyc_typed_list(int type);
+
+int holyc_typed_list_type_of(AST_T* value);
+
+void holyc_typed_list_reserve(holyc_typed_list_T* typed_list, size_t capacity);
+
+unsigned int holyc_typed_list_append(holyc_typed_list_T* typed_list, AST_T* value);
+
+void* holyc_typed_list_mutable_data(holyc_typed_list_T* typed_list);
+
+void holyc_typed_list_remove_at(holyc_typed_list_T* typed_list, size_t index);
+
+AST_T* holyc_typed_list_box(holyc_typed_list_T* typed_list, size_t index);
+
+holyc_typed_list_T* holyc_typed_list_copy(holyc_typed_list_T* typed_list);
+
+holyc_typed_list_T* holyc_typed_list_slice(holyc_typed_list_T* typed_list, size_t start, size_t end);
+
+void holyc_typed_list_free(holyc_typed_list_T* typed_list);
+#endif
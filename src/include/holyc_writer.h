@@ -0,0 +1,47 @@
+#ifndef HOLYC_WRITER_H
+#define HOLYC_WRITER_H
+#include <stdlib.h>
+#include <sys/uio.h>
+
+#define HOLYC_WRITER_DEFAULT_SIZE (64 * 1024)
+
+/* the most chunks written by one writev */
+#define HOLYC_WRITER_MAX_CHUNKS 64
+
+
+/**
+ * Buffered writer of a file descriptor. Small writes are copied into the
+ * buffer, large ones are queued next to the buffered chars and written
+ * together with a single writev instead of being copied.
+ * Queued chunks point into the buffer or into the strings that were
+ * written, so large strings are only queued until the write that queued
+ * them returns. Writers that are still open are flushed on exit.
+ */
+typedef struct holyc_WRITER_STRUCT
+{
+    int fd;
+    unsigned int owns_fd;
+    char* buffer;
+    size_t size;
+    size_t length;
+    /* chars of the buffer before `queued_length` are already in `chunks` */
+    size_t queued_length;
+    struct iovec chunks[HOLYC_WRITER_MAX_CHUNKS];
+    size_t chunk_count;
+    struct holyc_WRITER_STRUCT* next;
+} holyc_writer_T;
+
+holyc_writer_T* init_holyc_writer(int fd, size_t size, unsigned int owns_fd);
+
+void holyc_writer_queue(holyc_writer_T* writer, const char* str, size_t length);
+
+void holyc_writer_write(holyc_writer_T* writer, const char* str, size_t length);
+
+void holyc_writer_flush(holyc_writer_T* writer);
+
+void holyc_writer_flush_all(void);
+
+void holyc_writer_close(holyc_writer_T* writer);
+
+void holyc_writer_free(holyc_writer_T* writer);
+#endif
@@ -5,4 +5,6 @@
 
 
 char* holyc_read_file(const char* filename);
+
+char* holyc_read_file_length(const char* filename, size_t* read_length);
 #endif
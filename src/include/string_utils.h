@@ -1,6 +1,10 @@
 #ifndef HOLYC_STRING_UTILS_H
 #define HOLYC_STRING_UTILS_H
 #include <stdlib.h>
+#include <stdint.h>
+
+#define HOLYC_FNV1A_INIT 2166136261u
+
 char* holyc_char_to_string(char c);
 
 char* holyc_init_str(const char* value);
@@ -8,4 +12,6 @@ char* holyc_init_str(const char* value);
 char* holyc_get_stdin(const char* printstr);
 
 char *holyc_strrev(char *instr);
+
+uint32_t holyc_fnv1a(uint32_t hash, const char* data, size_t size);
 #endif
@@ -1,5 +1,6 @@
 #ifndef holyc_TOKEN_H
 #define holyc_TOKEN_H
+#include <stdlib.h>
 typedef struct TOKEN_STRUCT
 {
     enum
@@ -42,10 +43,13 @@ typedef struct TOKEN_STRUCT
     } type;
 
     char* value;
+    unsigned int line_n;
 } token_T;
 
 token_T* init_token(int type, char* value);
 
+token_T* init_token_slice(int type, const char* value, size_t length);
+
 token_T* token_copy(token_T* token);
 
 void token_free(token_T* token);
@@ -10,9 +10,25 @@
  * @return char*
  */
 char* holyc_read_file(const char* filename)
+{
+    return holyc_read_file_length(filename, (void*)0);
+}
+
+/**
+ * Reads the content of a file, and stores how many chars were read in
+ * `read_length`, which can differ from the size reported by stat if the
+ * file is written to at the same time.
+ *
+ * @param char* filename
+ * @param size_t* read_length NULL if not needed
+ *
+ * @return char*
+ */
+char* holyc_read_file_length(const char* filename, size_t* read_length)
 {
     char * buffer = 0;
     long length;
+    size_t read = 0;
     FILE * f = fopen (filename, "rb");
 
     if (f)
@@ -20,12 +36,16 @@ char* holyc_read_file(const char* filename)
         fseek (f, 0, SEEK_END);
         length = ftell (f);
         fseek (f, 0, SEEK_SET);
-        buffer = calloc (length, length);
+        buffer = calloc (length + 1, 1);
 
         if (buffer)
-            fread (buffer, 1, length, f);
+            read = fread (buffer, 1, length, f);
 
         fclose (f);
+
+        if (read_length)
+            *read_length = read;
+
         return buffer;
     }
 
@@ -4,7 +4,11 @@
 #include "include/holyc_cleanup.h"
 #include "include/string_utils.h"
 #include "include/io.h"
+#include "include/holyc_module.h"
+#include "include/holyc_include_cache.h"
+#include "include/holyc_server.h"
 #include <signal.h>
+#include <string.h>
 
 
 volatile unsigned int interactive;
@@ -48,10 +52,75 @@ int main(int argc, char* argv[])
         return 0;
     }
 
-    lexer = init_holyc_lexer(holyc_read_file(argv[1]));
-    parser = init_holyc_parser(lexer);
-    node = holyc_parser_parse(parser, (void*) 0);
-    runtime_visit(runtime, node);
+    if (argc >= 4 && strcmp(argv[1], "-c") == 0)
+    {
+        // compile argv[2] into the module argv[3], see holyc_module.h
+        lexer = init_holyc_lexer(holyc_read_file(argv[2]));
+        parser = init_holyc_parser(lexer);
+        node = holyc_parser_parse(parser, (void*) 0);
+        holyc_module_write(node, argv[3]);
+
+        holyc_cleanup(lexer, parser, runtime, node);
+
+        return 0;
+    }
+
+    if (argc >= 3 && strcmp(argv[1], "--serve") == 0)
+    {
+        // keeps a pool of warm workers running scripts sent to argv[2], see holyc_server.h
+        size_t workers = argc >= 4 ? (size_t) atoi(argv[3]) : 0;
+
+        return holyc_server_serve(runtime, argv[2], workers);
+    }
+
+    if (argc >= 3 && strcmp(argv[1], "--fork-server") == 0)
+    {
+        // forks a child per request from a process that ran the prelude and parsed the scripts.
+        const char* prelude = (void*)0;
+        int first_script = 3;
+
+        if (argc >= 5 && strcmp(argv[3], "--prelude") == 0)
+        {
+            prelude = argv[4];
+            first_script = 5;
+        }
+
+        return holyc_server_fork_serve(runtime, argv[2], prelude, argc - first_script, &argv[first_script]);
+    }
+
+    if (argc >= 4 && strcmp(argv[1], "--connect") == 0)
+        return holyc_server_connect(argv[2], argc - 3, &argv[3]);
+
+    // -n runs the script for every line of stdin, -p also prints the lines.
+    int lines_mode = 0;
+
+    if (argc >= 3 && (strcmp(argv[1], "-n") == 0 || strcmp(argv[1], "-p") == 0))
+    {
+        lines_mode = argv[1][1];
+        argc--;
+        argv++;
+    }
+
+    runtime_set_args(runtime, argc - 1, &argv[1]);
+
+    if (holyc_module_is_module(argv[1]))
+    {
+        node = holyc_module_load(argv[1]);
+    }
+    else
+    {
+        lexer = init_holyc_lexer(holyc_read_file(argv[1]));
+        parser = init_holyc_parser(lexer);
+        node = holyc_parser_parse(parser, (void*) 0);
+
+        // start parsing the included files while the script starts running.
+        holyc_include_cache_prefetch(runtime->include_cache, parser->include_paths);
+    }
+
+    if (lines_mode)
+        runtime_visit_lines(runtime, node, lines_mode == 'p');
+    else
+        runtime_visit(runtime, node);
 
     holyc_cleanup(lexer, parser, runtime, node);
 
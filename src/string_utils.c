@@ -30,6 +30,9 @@ char* holyc_get_stdin(const char* printstr)
 
     printf(">: ");
 
+    // stdout is fully buffered, see holyc_output.h
+    fflush(stdout);
+
     for(i = 0; (c = getchar()) != '\n' && c != EOF; ++i)
     {
         if(i == size)
@@ -77,3 +80,18 @@ char *holyc_strrev(char *intstr)
 
       return intstr;
 }
+
+/**
+ * FNV-1a hash of `size` bytes, start with HOLYC_FNV1A_INIT and pass the
+ * previous result to hash data in several parts.
+ */
+uint32_t holyc_fnv1a(uint32_t hash, const char* data, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= (unsigned char) data[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
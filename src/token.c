@@ -13,9 +13,22 @@ token_T* init_token(int type, char* value)
     return token;
 }
 
+token_T* init_token_slice(int type, const char* value, size_t length)
+{
+    token_T* token = calloc(1, sizeof(struct TOKEN_STRUCT));
+    token->type = type;
+    token->value = calloc(length + 1, sizeof(char));
+    memcpy(token->value, value, length);
+
+    return token;
+}
+
 token_T* token_copy(token_T* token)
 {
-    return init_token(token->type, token->value);
+    token_T* copy = init_token(token->type, token->value);
+    copy->line_n = token->line_n;
+
+    return copy;
 }
 
 void token_free(token_T* token)
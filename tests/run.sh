@@ -0,0 +1,44 @@
+#!/bin/sh
+# Runs every tests/*.hc and compares its output with tests/<name>.out.
+# A script with a tests/<name>.in runs with -n and that file as its input.
+
+holyc="${1:-./holyc.out}"
+failed=0
+
+for script in tests/*.hc; do
+    name="${script%.hc}"
+
+    if [ -f "$name.in" ]; then
+        output=$("$holyc" -n "$script" < "$name.in" 2>&1)
+    else
+        output=$("$holyc" "$script" 2>&1)
+    fi
+
+    if [ "$output" != "$(cat "$name.out")" ]; then
+        echo "FAIL $script"
+        echo "$output" | diff "$name.out" -
+        failed=1
+    fi
+done
+
+# one worker runs the same script twice, the second run sees its own arguments.
+socket="${TMPDIR:-/tmp}/holyc-check-$$.sock"
+"$holyc" --serve "$socket" 1 > /dev/null 2>&1 &
+server=$!
+
+tries=0
+while [ ! -S "$socket" ] && [ $tries -lt 50 ]; do
+    sleep 0.1
+    tries=$((tries + 1))
+done
+
+output=$("$holyc" --connect "$socket" tests/serve/argv.hc A B 2>&1; "$holyc" --connect "$socket" tests/serve/argv.hc C 2>&1)
+kill $server
+
+if [ "$output" != "$(cat tests/serve/argv.out)" ]; then
+    echo "FAIL tests/serve/argv.hc"
+    echo "$output" | diff tests/serve/argv.out -
+    failed=1
+fi
+
+exit $failed